@@ -1,5 +1,8 @@
 ////////////////////////////////
 /// usage : 1.	TSP solver with optimal tour cache.
+///         2.	solve a batch of node sets concurrently on a persistent thread pool.
+///         3.	induce the candidate set of each node set from the candidate graph of the whole instance.
+///         4.	solve each node set on a view of the cost matrix of the whole instance if it is provided.
 /// 
 /// note  : 1.	
 ////////////////////////////////
@@ -8,10 +11,21 @@
 #define SMART_SZX_GOAL_LKH3LIB_CACHED_TSP_SOLVER_H
 
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "TspCache.h"
 #include "TspSolver.h"
+#include "ThreadPool.h"
 
 
 namespace szx {
@@ -25,14 +39,32 @@ namespace szx {
 		using AdjMat = lkh::AdjMat;
 		using AdjList = lkh::AdjList;
 		using EdgeList = lkh::EdgeList;
+		using CandidateGraph = lkh::CandidateGraph;
 		using TspCache = TspCache<Tour>;
 
 		using MapNodeId = std::function<ID(ID)>;
 
+		struct NodeSetRequest {
+			TspCache::NodeSet containNode;
+			CoordList2D coords; // coords[i] is the coordinate of node nodeIds[i].
+			std::vector<ID> nodeIds;
+		};
 
-		CachedTspSolver(lkh::ID nodeNum) : tspCache(nodeNum) {}
-		CachedTspSolver(lkh::ID nodeNum, const std::string &cacheFilePath)
-			: tspCache(nodeNum), cachePath(cacheFilePath) {
+
+		// keep more candidates than LKH uses since most of them are absent in the node sets.
+		static constexpr int GlobalCandidateNum = 2 * lkh::DefaultMaxCandidateNum;
+		static constexpr int MinCandidateNum = lkh::DefaultMaxCandidateNum;
+		static constexpr Weight TopUpAlpha = (std::numeric_limits<Weight>::max)() - 1; // LKH drops candidates with `INT_MAX` alpha.
+
+
+		static int defaultBatchThreadNum() { return (std::max)(1, static_cast<int>(std::thread::hardware_concurrency())); }
+
+
+		// `batchThreadNum` is the number of node sets solved at the same time in `solveBatch()`.
+		CachedTspSolver(lkh::ID nodeNum, int batchThreadNum = defaultBatchThreadNum())
+			: tspCache(nodeNum), hitNum(0), missNum(0), batchPool(new ThreadPool<>((std::max)(1, batchThreadNum))) {}
+		CachedTspSolver(lkh::ID nodeNum, const std::string &cacheFilePath, int batchThreadNum = defaultBatchThreadNum())
+			: tspCache(nodeNum), cachePath(cacheFilePath), hitNum(0), missNum(0), batchPool(new ThreadPool<>((std::max)(1, batchThreadNum))) {
 			tspCache.load(cachePath);
 		}
 
@@ -41,15 +73,16 @@ namespace szx {
 
 		template<typename InputData>
 		bool solve(Tour &sln, const TspCache::NodeSet &containNode, const InputData &input, MapNodeId mapId, const Tour &hintSln = Tour()) {
-			const Tour &cachedTour(tspCache.get(containNode));
-			if (cachedTour.nodes.empty() || cachedTour.nodes.size() != input.size()) {
+			Tour cachedTour; // take a copy since other threads may overwrite the entry.
+			if (!tspCache.get(cachedTour, containNode) || cachedTour.nodes.size() != input.size()) {
+				++missNum;
 				if (!lkh::solveTsp(sln, input, hintSln)) { return false; }
 				if (mapId) { // recover node ID.
 					for (auto n = sln.nodes.begin(); n != sln.nodes.end(); ++n) { *n = mapId(*n); }
 				}
-				tspCache.set(sln, containNode); // TODO[szx][0]: is it thread safe?
+				tspCache.set(sln, containNode);
 			}
-			else { sln = cachedTour; }
+			else { sln = std::move(cachedTour); ++hitNum; }
 
 			return true;
 		}
@@ -59,9 +92,144 @@ namespace szx {
 		}
 		//bool solve(Tour &sln, const EdgeList &edgeList, const Tour &hintSln = Tour()) {}
 
+		// `adjMat[n][m]` is the distance from node n to node m in the whole instance.
+		// the node sets in `solveBatch()` will be solved on the submatrix of it instead of the coordinates once it is set,
+		// so that the tour lengths are measured in exactly the same way as the caller.
+		void initCostMatrix(const AdjMat &adjMat) { costMatrix = adjMat; }
+
+		// `coords[n]` is the coordinate of node n in the whole instance.
+		// the node sets in `solveBatch()` will skip the subgradient ascent once the candidate graph is built.
+		bool initCandidateGraph(const CoordList2D &coords, int maxCandidateNum = GlobalCandidateNum) {
+			return lkh::buildCandidateGraph(candidateGraph, coords, maxCandidateNum);
+		}
+
+		// return the tours in the order of the requests with the original node IDs.
+		// the requests with the same node set or cached tours are only solved once.
+		bool solveBatch(std::vector<Tour> &tours, const std::vector<NodeSetRequest> &requests) {
+			int requestNum = static_cast<int>(requests.size());
+			tours.clear();
+			tours.resize(requestNum);
+
+			std::vector<int> origins(requestNum, -1); // origins[r] is the first request with the same node set.
+			std::map<TspCache::NodeSet, int> firstRequests;
+			std::vector<int> misses;
+			for (int r = 0; r < requestNum; ++r) {
+				const NodeSetRequest &request(requests[r]);
+				auto first = firstRequests.emplace(request.containNode, r);
+				if (!first.second) { origins[r] = first.first->second; continue; }
+				if (request.coords.size() <= 2) { tours[r].nodes = request.nodeIds; continue; } // trivial cases.
+				if (tspCache.get(tours[r], request.containNode) && (tours[r].nodes.size() == request.coords.size())) { ++hitNum; continue; }
+				misses.push_back(r);
+			}
+			missNum += misses.size();
+
+			std::atomic<bool> isAllSolved(true);
+			if (misses.size() == 1) {
+				isAllSolved = solveMiss(tours[misses.front()], requests[misses.front()]);
+			}
+			else if (!misses.empty()) {
+				std::mutex restMutex;
+				std::condition_variable restCv;
+				size_t restNum = misses.size();
+				for (auto r = misses.begin(); r != misses.end(); ++r) {
+					int index = *r;
+					batchPool->push([&, index]() {
+						if (!solveMiss(tours[index], requests[index])) { isAllSolved = false; }
+						std::lock_guard<std::mutex> restLock(restMutex);
+						if (--restNum == 0) { restCv.notify_one(); }
+					});
+				}
+				std::unique_lock<std::mutex> restLock(restMutex);
+				restCv.wait(restLock, [&]() { return (restNum == 0); });
+			}
+
+			for (int r = 0; r < requestNum; ++r) {
+				if (origins[r] >= 0) { tours[r] = tours[origins[r]]; }
+			}
+			return isAllSolved;
+		}
+
+
+		// the trivial node sets and the duplicated ones in a batch are not counted.
+		long long getHitNum() const { return hitNum; }
+		long long getMissNum() const { return missNum; }
+
 
 		TspCache tspCache;
 		std::string cachePath;
+
+	protected:
+		bool solveMiss(Tour &sln, const NodeSetRequest &request) {
+			CandidateGraph candidates;
+			if (!candidateGraph.empty()) { induceCandidates(candidates, request); }
+			bool isSolved;
+			if (costMatrix.empty()) {
+				isSolved = candidateGraph.empty()
+					? lkh::solveTsp(sln, request.coords)
+					: lkh::solveTsp(sln, request.coords, candidates);
+			}
+			else {
+				lkh::AdjMatView adjMat(costMatrix, request.nodeIds);
+				isSolved = candidateGraph.empty()
+					? lkh::solveTsp(sln, adjMat)
+					: lkh::solveTsp(sln, adjMat, candidates);
+			}
+			if (!isSolved) { return false; }
+			for (auto n = sln.nodes.begin(); n != sln.nodes.end(); ++n) { *n = request.nodeIds[*n]; } // recover node ID.
+			tspCache.set(sln, request.containNode);
+			return true;
+		}
+
+		// keep the global candidates in the node set and top up the nodes with too few candidates
+		// by their nearest neighbors in the node set, so that it takes nearly linear time in the node set size.
+		void induceCandidates(CandidateGraph &candidates, const NodeSetRequest &request) const {
+			ID nodeNum = static_cast<ID>(request.nodeIds.size());
+			std::unordered_map<ID, ID> localIds(nodeNum);
+			for (ID n = 0; n < nodeNum; ++n) { localIds[request.nodeIds[n]] = n; }
+
+			candidates = CandidateGraph(nodeNum);
+			std::vector<ID> nearest;
+			for (ID n = 0; n < nodeNum; ++n) {
+				auto &adjNodes(candidates[n]);
+				const auto &globalAdjNodes(candidateGraph[request.nodeIds[n]]);
+				for (auto m = globalAdjNodes.begin(); m != globalAdjNodes.end(); ++m) {
+					auto localId = localIds.find(m->dst);
+					if (localId != localIds.end()) { adjNodes.push_back(lkh::AdjNode(localId->second, m->weight)); }
+				}
+
+				int lackNum = ((nodeNum - 1 < MinCandidateNum) ? (nodeNum - 1) : MinCandidateNum) - static_cast<int>(adjNodes.size());
+				if (lackNum <= 0) { continue; }
+				nearest.clear();
+				for (ID m = 0; m < nodeNum; ++m) {
+					if (m == n) { continue; }
+					if (std::any_of(adjNodes.begin(), adjNodes.end(), [m](const lkh::AdjNode &a) { return (a.dst == m); })) { continue; }
+					nearest.push_back(m);
+				}
+				auto squaredDist = [&](ID m) {
+					if (!costMatrix.empty()) {
+						double d = costMatrix.at(request.nodeIds[n], request.nodeIds[m]);
+						return d * d;
+					}
+					double dx = request.coords[n].x - request.coords[m].x;
+					double dy = request.coords[n].y - request.coords[m].y;
+					return dx * dx + dy * dy;
+				};
+				lackNum = (std::min)(lackNum, static_cast<int>(nearest.size()));
+				std::partial_sort(nearest.begin(), nearest.begin() + lackNum, nearest.end(), [&](ID m1, ID m2) {
+					return squaredDist(m1) < squaredDist(m2);
+				});
+				for (auto m = nearest.begin(); m != nearest.begin() + lackNum; ++m) { adjNodes.push_back(lkh::AdjNode(*m, TopUpAlpha)); }
+			}
+		}
+
+
+		CandidateGraph candidateGraph; // indexed by the original node ID.
+		AdjMat costMatrix; // indexed by the original node ID.
+
+		std::atomic<long long> hitNum;
+		std::atomic<long long> missNum;
+
+		std::unique_ptr<ThreadPool<>> batchPool; // destructed first so that no job refers to the other members.
 	};
 
 
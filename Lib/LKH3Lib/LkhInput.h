@@ -295,6 +295,10 @@ struct Configuration { // tunes the performance of the core algorithm.
 };
 
 
+// the matrix view of the problem being solved in the current thread, which is defined in TspSolver.cpp.
+extern thread_local const AdjMatView *ViewInUse;
+
+
 struct Problem {
     #pragma region Setter
     #pragma region SetEdgeWeightType
@@ -416,8 +420,17 @@ struct Problem {
         WeightType = SPECIAL;
         Distance = Distance_SPECIAL;
     }
+    static void setEdgeWeightType_VIEW(const AdjMatView &adjMat) {
+        WeightType = SPECIAL;
+        Distance = Distance_VIEW;
+        ViewInUse = &adjMat;
+    }
     #pragma endregion SetEdgeWeightType
 
+    static int Distance_VIEW(Node *Na, Node *Nb) {
+        return ViewInUse->at(Na->Id - LkhIdBase, Nb->Id - LkhIdBase);
+    }
+
     #pragma region CopyCoord
     static void copyCoord2D(Node &n, const Coord2D &c) {
         n.X = c.x;
@@ -482,6 +495,22 @@ struct Problem {
         postprocess();
     }
 
+    // the distances are looked up in the view on demand, so no cost matrix will be allocated.
+    static void load(const AdjMatView &adjMat) {
+        preprocess();
+
+        setNodeNum(adjMat.size());
+
+        EdgeWeightType = Copy("SPECIAL");
+        setEdgeWeightType_VIEW(adjMat);
+
+        CoordType = NO_COORDS;
+        CheckSpecificationPart();
+        if (!FirstNode) { CreateNodes(); }
+
+        postprocess();
+    }
+
     static void load(const AdjMat &adjMat, EdgeWeightFormats weightFormat) {
         preprocess();
 
@@ -1036,7 +1065,8 @@ struct Problem {
         if (CostMatrix == 0 && Dimension <= MaxMatrixDimension &&
             Distance != 0 && Distance != Distance_1 && Distance != Distance_LARGE
             && Distance != Distance_LARGE && Distance != Distance_ATSP
-            && Distance != Distance_MTSP && Distance != Distance_SPECIAL) {
+            && Distance != Distance_MTSP && Distance != Distance_SPECIAL
+            && Distance != Distance_VIEW) {
             Node *Ni, *Nj;
             assert(CostMatrix =
                 (int *)calloc((size_t)Dim * (Dim - 1) / 2, sizeof(int)));
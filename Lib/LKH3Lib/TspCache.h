@@ -14,6 +14,7 @@
 #include <functional>
 #include <unordered_map>
 #include <mutex>
+#include <shared_mutex>
 
 #include "Graph.h"
 
@@ -83,6 +84,9 @@ struct TspCacheBase {
     // if the returned tour is `tour`, call `tour.empty()` to check the status.
     virtual const Tour& get(const NodeSet &containNode) const = 0;
     virtual const Tour& get(const NodeList &orderedNodes) const = 0; // the orderedNodes is a list of node IDs in increasing order.
+    // copy the cached tour into `sln` while holding the read lock, so it is safe against concurrent `set()`.
+    // return false if cache miss happens.
+    virtual bool get(Tour &sln, const NodeSet &containNode) const = 0;
 
     // return true if overwriting happens or a new entry is added, otherwise better tour already exists.
     virtual bool set(const Tour &sln, const NodeSet &containNode) = 0;
@@ -132,6 +136,8 @@ public:
 
 
     virtual const Tour& get(const NodeSet &containNode) const override {
+        std::shared_lock<std::shared_timed_mutex> readLock(cacheMutex);
+
         TreeNodeID treeNode = 0;
         for (auto n = containNode.begin(); n != containNode.end(); ++n) {
             treeNode = nodePool[treeNode][*n];
@@ -139,13 +145,24 @@ public:
         }
         return tourPool[treeNode]; // tour found.
     }
+    virtual bool get(Tour &sln, const NodeSet &containNode) const override {
+        std::shared_lock<std::shared_timed_mutex> readLock(cacheMutex);
+
+        TreeNodeID treeNode = 0;
+        for (auto n = containNode.begin(); n != containNode.end(); ++n) {
+            treeNode = nodePool[treeNode][*n];
+            if (treeNode < 0) { return false; } // cache miss.
+        }
+        sln = tourPool[treeNode]; // tour found.
+        return true;
+    }
 
     virtual const Tour& get(const NodeList &orderedNodes) const override {
         return get(toNodeSet(orderedNodes));
     }
 
     virtual bool set(const Tour &sln, const NodeSet &containNode) override {
-        std::lock_guard<std::mutex> writeLock(writeMutex);
+        std::lock_guard<std::shared_timed_mutex> writeLock(cacheMutex);
 
         TreeNodeID treeNode = 0;
         auto lastNode = containNode.end() - 1;
@@ -191,7 +208,7 @@ public:
 
     std::vector<BinTreeNode> nodePool;
     std::vector<Tour> tourPool;
-    std::mutex writeMutex;
+    mutable std::shared_timed_mutex cacheMutex; // concurrent `get()` and exclusive `set()`.
 };
 
 
@@ -218,17 +235,27 @@ struct TspCache_HashImpl : public TspCacheBase<Tour> {
 
 
     virtual const Tour& get(const NodeSet &containNode) const override {
+        std::shared_lock<std::shared_timed_mutex> readLock(cacheMutex);
+
         auto t = tourMap.find(containNode);
         if (t == tourMap.end()) { return emptyTour(); } // cache miss.
         return t->second; // tour found.
     }
+    virtual bool get(Tour &sln, const NodeSet &containNode) const override {
+        std::shared_lock<std::shared_timed_mutex> readLock(cacheMutex);
+
+        auto t = tourMap.find(containNode);
+        if (t == tourMap.end()) { return false; } // cache miss.
+        sln = t->second; // tour found.
+        return true;
+    }
 
     virtual const Tour& get(const NodeList &orderedNodes) const override {
         return get(toNodeSet(orderedNodes));
     }
 
     virtual bool set(const Tour &sln, const NodeSet &containNode) override {
-        std::lock_guard<std::mutex> writeLock(writeMutex);
+        std::lock_guard<std::shared_timed_mutex> writeLock(cacheMutex);
 
         auto t = tourMap.find(containNode);
         if (t == tourMap.end()) {
@@ -259,7 +286,7 @@ struct TspCache_HashImpl : public TspCacheBase<Tour> {
 
 
     std::unordered_map<NodeSet, Tour> tourMap;
-    std::mutex writeMutex;
+    mutable std::shared_timed_mutex cacheMutex; // concurrent `get()` and exclusive `set()`.
 };
 
 
@@ -15,7 +15,44 @@ using namespace std;
 
 namespace szx {
 
-int lhkMain(lkh::Tour &sln, const lkh::Tour &hintSln) {
+// the in-memory counterpart of reading the candidate file and the penalty file in `CreateCandidateSet()`.
+// the Pi-values are zero and the lower bound is unknown since the subgradient ascent is skipped.
+void injectCandidateSet(const lkh::CandidateGraph &candidates) {
+    Node *N;
+    int i;
+
+    Norm = 9999;
+    if (C == C_EXPLICIT) {
+        N = FirstNode;
+        do {
+            for (i = 1; i < N->Id; i++)
+                N->C[i] *= Precision;
+        } while ((N = N->Suc) != FirstNode);
+    }
+    N = FirstNode;
+    do { N->Pi = 0; } while ((N = N->Suc) != FirstNode);
+
+    for (lkh::ID s = lkh::LkhIdBase; s <= Dim; ++s) {
+        Node *src = &NodeSet[s];
+        const auto &adjNodes(candidates[s - lkh::LkhIdBase]);
+        for (auto n = adjNodes.begin(); n != adjNodes.end(); ++n) {
+            Node *dst = &NodeSet[n->dst + lkh::LkhIdBase];
+            AddCandidate(src, dst, D(src, dst), n->weight);
+        }
+    }
+    AddTourCandidates();
+    SymmetrizeCandidateSet();
+    ResetCandidateSet();
+    if (MaxCandidates > 0) { TrimCandidateSet(MaxCandidates); }
+    if (ExtraCandidates > 0) {
+        AddExtraCandidates(ExtraCandidates, ExtraCandidateSetType, ExtraCandidateSetSymmetric);
+        AddTourCandidates();
+        ResetCandidateSet();
+    }
+    LowerBound = 0;
+}
+
+int lhkMain(lkh::Tour &sln, const lkh::Tour &hintSln, const lkh::CandidateGraph *candidates = nullptr) {
     if (!hintSln.nodes.empty()) {
         // EXTEND[szx][0]: utilize initial solution.
     }
@@ -49,7 +86,11 @@ int lhkMain(lkh::Tour &sln, const lkh::Tour &hintSln) {
         VRPB_Reduce();
     if (ProblemType == PDPTW)
         PDPTW_Reduce();
-    CreateCandidateSet();
+    if (candidates) {
+        injectCandidateSet(*candidates);
+    } else {
+        CreateCandidateSet();
+    }
     InitializeStatistics();
 
     if (Norm != 0 || Penalty) {
@@ -276,6 +317,9 @@ int lhkMain(lkh::Tour &sln, const lkh::Tour &hintSln) {
 
 namespace lkh {
 
+thread_local const AdjMatView *ViewInUse = nullptr;
+
+
 bool solveTsp(Tour &sln, const CoordList2D &coordList, const Tour &hintSln) {
     bool r;
     thread t([&]() {
@@ -288,6 +332,18 @@ bool solveTsp(Tour &sln, const CoordList2D &coordList, const Tour &hintSln) {
     return (r == EXIT_SUCCESS);
 }
 
+bool solveTsp(Tour &sln, const CoordList2D &coordList, const CandidateGraph &candidates, const Tour &hintSln) {
+    bool r;
+    thread t([&]() {
+        Environment::load();
+        Configuration::load();
+        Problem::load(coordList);
+        r = lhkMain(sln, hintSln, &candidates);
+    });
+    t.join();
+    return (r == EXIT_SUCCESS);
+}
+
 bool solveTsp(Tour &sln, const CoordList3D &coordList, const Tour &hintSln) {
     bool r;
     thread t([&]() {
@@ -300,6 +356,59 @@ bool solveTsp(Tour &sln, const CoordList3D &coordList, const Tour &hintSln) {
     return (r == EXIT_SUCCESS);
 }
 
+bool solveTsp(Tour &sln, const AdjMatView &adjMat, const Tour &hintSln) {
+    bool r;
+    thread t([&]() {
+        Environment::load();
+        Configuration::load();
+        Problem::load(adjMat);
+        r = lhkMain(sln, hintSln);
+    });
+    t.join();
+    return (r == EXIT_SUCCESS);
+}
+
+bool solveTsp(Tour &sln, const AdjMatView &adjMat, const CandidateGraph &candidates, const Tour &hintSln) {
+    bool r;
+    thread t([&]() {
+        Environment::load();
+        Configuration::load();
+        Problem::load(adjMat);
+        r = lhkMain(sln, hintSln, &candidates);
+    });
+    t.join();
+    return (r == EXIT_SUCCESS);
+}
+
+bool buildCandidateGraph(CandidateGraph &candidates, const CoordList2D &coordList, int maxCandidateNum) {
+    candidates = CandidateGraph(static_cast<ID>(coordList.size()));
+    if (coordList.size() <= 2) { // LKH rejects trivial instances.
+        for (ID n = 0; n < static_cast<ID>(coordList.size()); ++n) {
+            for (ID m = 0; m < static_cast<ID>(coordList.size()); ++m) {
+                if (m != n) { candidates[n].push_back(AdjNode(m, 0)); }
+            }
+        }
+        return true;
+    }
+
+    thread t([&]() {
+        Environment::load();
+        Configuration::load();
+        MaxCandidates = maxCandidateNum;
+        Problem::load(coordList);
+        AllocateStructures();
+        CreateCandidateSet();
+        for (ID s = LkhIdBase; s <= Dim; ++s) {
+            for (Candidate *c = NodeSet[s].CandidateSet; c && c->To; ++c) {
+                candidates[s - LkhIdBase].push_back(AdjNode(c->To->Id - LkhIdBase, c->Alpha));
+            }
+        }
+        FreeStructures();
+    });
+    t.join();
+    return true;
+}
+
 bool solveTsp(Tour &sln, const AdjMat &adjMat, const Tour &hintSln) {
     bool r;
     thread t([&]() {
@@ -31,8 +31,24 @@ using EdgeList = Graph::EdgeList<Edge>;
 
 using Tour = Graph::Tour<Weight>;
 
+using CandidateGraph = AdjList; // `candidateGraph[n][i].weight` is the alpha-nearness of the `i`_th candidate of node `n`.
+
 
 static constexpr ID LkhIdBase = 1;
+static constexpr int DefaultMaxCandidateNum = 5;
+
+
+// read-only view of the submatrix on the rows and columns of `nodeIds` in a square matrix.
+// the distances are looked up directly in the original matrix instead of being copied into LKH.
+struct AdjMatView {
+    AdjMatView(const AdjMat &adjMat, const std::vector<ID> &nodeIdList) : mat(&adjMat), nodeIds(&nodeIdList) {}
+
+    Weight at(ID i, ID j) const { return mat->at((*nodeIds)[i], (*nodeIds)[j]); }
+    ID size() const { return static_cast<ID>(nodeIds->size()); }
+
+    const AdjMat *mat;
+    const std::vector<ID> *nodeIds; // `nodeIds[i]` is the row and column index in `mat` of node `i` in the view.
+};
 
 
 bool solveTsp(Tour &sln, const CoordList2D &coordList, const Tour &hintSln = Tour());
@@ -41,6 +57,15 @@ bool solveTsp(Tour &sln, const AdjMat &adjMat, const Tour &hintSln = Tour());
 bool solveTsp(Tour &sln, const AdjList &adjList, const Tour &hintSln = Tour());
 bool solveTsp(Tour &sln, const EdgeList &edgeList, Graph::ID nodeNum, const Tour &hintSln = Tour());
 
+// create the alpha-nearness candidate set (including the subgradient ascent) of the whole instance.
+bool buildCandidateGraph(CandidateGraph &candidates, const CoordList2D &coordList, int maxCandidateNum = DefaultMaxCandidateNum);
+// skip the candidate set creation by injecting the candidates of each node in the local node ID.
+bool solveTsp(Tour &sln, const CoordList2D &coordList, const CandidateGraph &candidates, const Tour &hintSln = Tour());
+
+// the view should be symmetric.
+bool solveTsp(Tour &sln, const AdjMatView &adjMat, const Tour &hintSln = Tour());
+bool solveTsp(Tour &sln, const AdjMatView &adjMat, const CandidateGraph &candidates, const Tour &hintSln = Tour());
+
 }
 }
 
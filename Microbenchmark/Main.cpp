@@ -0,0 +1,25 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "Microbenchmark.h"
+
+using namespace std;
+using namespace szx;
+
+// Microbenchmark.exe [instancePath] [sampleNum] [reportPath] [randSeed]
+int main(int argc, char *argv[]) {
+	String instPath((argc > 1) ? argv[1] : Microbenchmark::DefaultInstancePath());
+	int sampleNum = (argc > 2) ? atoi(argv[2]) : Microbenchmark::DefaultSampleNum;
+	String reportPath((argc > 3) ? argv[3] : Microbenchmark::DefaultReportPath());
+	int randSeed = (argc > 4) ? atoi(argv[4]) : Random::generateSeed();
+
+	Microbenchmark mb(instPath, randSeed, sampleNum);
+	if (!mb.run()) {
+		cerr << "fail to load " << instPath << endl;
+		return -1;
+	}
+	mb.print(cout);
+	mb.save(reportPath);
+
+	return 0;
+}
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+
+#include "Microbenchmark.h"
+
+using namespace std;
+
+namespace szx {
+
+	Microbenchmark::~Microbenchmark() {
+		if (solver) { delete solver->tspSolver; }
+	}
+
+	bool Microbenchmark::run() {
+		if (!input.load(env.instPath)) { return false; }
+		cfg.load(Env::DefaultCfgPath());
+
+		solver.reset(new Solver(input, env, cfg));
+		solver->tspSolver = nullptr;
+		solver->init();
+		solver->initTspSolver(); // do not touch the persistent TSP cache.
+
+		stats.clear();
+		benchCallModel();
+		benchCallLkh();
+		benchTspCache();
+		benchBuildMixNeigh();
+		return true;
+	}
+
+	void Microbenchmark::print(ostream &os) const {
+		os << left << setw(16) << "kernel" << setw(12) << "param"
+			<< right << setw(8) << "samples" << setw(12) << "min(us)" << setw(12) << "median(us)"
+			<< setw(12) << "p95(us)" << setw(12) << "mean(us)" << endl;
+		os << fixed << setprecision(3);
+		for (auto s = stats.begin(); s != stats.end(); ++s) {
+			os << left << setw(16) << s->kernel << setw(12) << s->param
+				<< right << setw(8) << s->sampleNum << setw(12) << s->min << setw(12) << s->median
+				<< setw(12) << s->p95 << setw(12) << s->mean << endl;
+		}
+		os << defaultfloat;
+	}
+
+	bool Microbenchmark::save(const String &path) const {
+		auto pos = path.find_last_of('/');
+		if (pos != String::npos) { System::makeSureDirExist(path.substr(0, pos + 1)); }
+
+		ofstream ofs(path, ios::app);
+		if (!ofs.is_open()) { return false; }
+		ofs.seekp(0, ios::end);
+		if (ofs.tellp() <= 0) {
+			ofs << "Time,Instance,RandSeed,Kernel,Param,SampleNum,Min(us),Median(us),P95(us),Mean(us)" << endl;
+		}
+		for (auto s = stats.begin(); s != stats.end(); ++s) {
+			ofs << env.friendlyLocalTime() << "," << env.friendlyInstName() << "," << env.randSeed << ","
+				<< s->kernel << "," << s->param << "," << s->sampleNum << ","
+				<< s->min << "," << s->median << "," << s->p95 << "," << s->mean << endl;
+		}
+		return true;
+	}
+
+	template<typename Prepare, typename Kernel>
+	void Microbenchmark::measure(const String &kernel, const String &param, Prepare prepare, Kernel run, int opNum) {
+		using Clock = chrono::steady_clock;
+
+		vector<double> samples;
+		samples.reserve(sampleNum);
+		for (int s = 0; s < WarmUpNum + sampleNum; ++s) {
+			prepare(s);
+			Clock::time_point start = Clock::now();
+			run(s);
+			double duration = chrono::duration<double, micro>(Clock::now() - start).count();
+			if (s >= WarmUpNum) { samples.push_back(duration / opNum); }
+		}
+		stats.push_back(summarize(kernel, param, samples));
+	}
+
+	void Microbenchmark::benchCallModel() {
+		for (auto r = VisitRates().begin(); r != VisitRates().end(); ++r) {
+			vector<VisitMatrix> samples(WarmUpNum + sampleNum);
+			for (auto v = samples.begin(); v != samples.end(); ++v) { randomFeasibleVisits(*v, *r); }
+
+			measure("callModel", to_string(*r), [&](int) {
+				solver->aux.modelCache.clear();
+			}, [&](int s) {
+				solver->callModel(samples[s]);
+			});
+		}
+	}
+
+	void Microbenchmark::benchCallLkh() {
+		ID customerNum = solver->nodeNum - input.depotnum();
+		VisitMatrix visits(solver->periodNum, solver->nodeNum);
+		for (auto k = TourSizes().begin(); k != TourSizes().end(); ++k) {
+			if (*k > customerNum) { break; }
+			List<ID> customers(customerNum);
+			iota(customers.begin(), customers.end(), input.depotnum());
+
+			// a new node set is drawn for each sample so that the TSP cache always misses.
+			measure("callLKH", to_string(*k), [&](int) {
+				visits.reset();
+				visits[0][0] = 1;
+				for (ID i = 0; i < *k; ++i) { // partial Fisher-Yates shuffle.
+					swap(customers[i], customers[i + rand.pick(customerNum - i)]);
+					visits[0][customers[i]] = 1;
+				}
+			}, [&](int) {
+				solver->callLKH(visits, 0);
+			});
+		}
+	}
+
+	void Microbenchmark::benchTspCache() {
+		using TspCache = CachedTspSolver::TspCache;
+
+		ID nodeNum = solver->nodeNum;
+		ID tourSize = (max)(1, nodeNum / solver->periodNum);
+		List<TspCache::NodeSet> hits;
+		List<TspCache::NodeSet> misses(CacheOpNumPerSample);
+		List<CachedTspSolver::Tour> tours(CacheOpNumPerSample);
+		CachedTspSolver::Tour tour;
+		for (auto l = CacheFillLevels().begin(); l != CacheFillLevels().end(); ++l) {
+			TspCache cache(nodeNum);
+			hits.resize(*l);
+			for (auto h = hits.begin(); h != hits.end(); ++h) {
+				randomNodeSet(*h, tour, nodeNum, tourSize);
+				cache.set(tour, *h);
+			}
+
+			if (!hits.empty()) {
+				measure("tspCacheHit", to_string(*l), [&](int) {}, [&](int s) {
+					for (int i = 0; i < CacheOpNumPerSample; ++i) { cache.get(tour, hits[(s * CacheOpNumPerSample + i) % hits.size()]); }
+				}, CacheOpNumPerSample);
+			}
+
+			auto prepareMisses = [&](int) {
+				for (int i = 0; i < CacheOpNumPerSample; ++i) { randomNodeSet(misses[i], tours[i], nodeNum, tourSize); }
+			};
+			measure("tspCacheMiss", to_string(*l), prepareMisses, [&](int) {
+				for (int i = 0; i < CacheOpNumPerSample; ++i) { cache.get(tour, misses[i]); }
+			}, CacheOpNumPerSample);
+
+			// the entries added by the previous sample are erased, so that all the samples see the same fill level.
+			auto eraseMisses = [&]() {
+				for (auto m = misses.begin(); m != misses.end(); ++m) { cache.tourMap.erase(*m); }
+			};
+			measure("tspCacheSet", to_string(*l), [&](int s) {
+				if (s > 0) { eraseMisses(); }
+				prepareMisses(s);
+			}, [&](int) {
+				for (int i = 0; i < CacheOpNumPerSample; ++i) { cache.set(tours[i], misses[i]); }
+			}, CacheOpNumPerSample);
+			eraseMisses();
+		}
+	}
+
+	void Microbenchmark::benchBuildMixNeigh() {
+		for (auto r = VisitRates().begin(); r != VisitRates().end(); ++r) {
+			VisitMatrix initVisits;
+			randomFeasibleVisits(initVisits, *r);
+			Price cost = solver->callModel(initVisits) + solver->callLKH(initVisits);
+			solver->aux.bestCost = cost;
+			solver->aux.bestVisits = initVisits;
+			solver->execTabu(initVisits, true);
+
+			VisitMatrix visits;
+			measure("buildMixNeigh", to_string(*r), [&](int) {
+				visits = initVisits;
+				solver->aux.modelCache.clear();
+			}, [&](int) {
+				solver->buildMixNeigh(visits);
+			});
+		}
+	}
+
+	void Microbenchmark::randomFeasibleVisits(VisitMatrix &visits, double visitRate) {
+		static constexpr int MaxTryNum = 64;
+		static constexpr unsigned RateScale = 1000;
+
+		ID periodNum = solver->periodNum;
+		ID nodeNum = solver->nodeNum;
+		const VisitMatrix &forced(solver->aux.forcedVisits);
+		const VisitMatrix &forbidden(solver->aux.forbiddenVisits);
+		unsigned rate = static_cast<unsigned>(visitRate * RateScale);
+		visits.init(periodNum, nodeNum);
+		for (int t = 0; t < MaxTryNum; ++t) {
+			for (ID p = 0; p < periodNum; ++p) {
+				visits[p][0] = 1;
+				for (ID n = input.depotnum(); n < nodeNum; ++n) {
+					visits[p][n] = forced.at(p, n) || (!forbidden.at(p, n) && rand.isPicked(rate, RateScale));
+				}
+			}
+			if (solver->callModel(visits) >= 0) { return; }
+		}
+		for (ID p = 0; p < periodNum; ++p) {
+			for (ID n = input.depotnum(); n < nodeNum; ++n) { visits[p][n] = !forbidden.at(p, n); }
+		}
+	}
+
+	void Microbenchmark::randomNodeSet(CachedTspSolver::TspCache::NodeSet &containNode, CachedTspSolver::Tour &tour, ID totalNum, ID nodeNum) {
+		containNode.assign(totalNum, false);
+		tour.distance = 0;
+		tour.nodes.clear();
+		for (ID n = 0; n < totalNum; ++n) { // select each node with the rest probability to get exactly `nodeNum` nodes.
+			if (rand.pick(totalNum - n) >= nodeNum - static_cast<ID>(tour.nodes.size())) { continue; }
+			containNode[n] = true;
+			tour.nodes.push_back(n);
+		}
+	}
+
+	Microbenchmark::Stat Microbenchmark::summarize(const String &kernel, const String &param, vector<double> &samples) {
+		// the value at rank ceil(q * n) in increasing order.
+		auto quantile = [&](double q) {
+			size_t rank = static_cast<size_t>(ceil(q * samples.size()));
+			return samples[(max)(rank, static_cast<size_t>(1)) - 1];
+		};
+
+		Stat stat;
+		stat.kernel = kernel;
+		stat.param = param;
+		stat.sampleNum = static_cast<int>(samples.size());
+		if (samples.empty()) { return stat; }
+		sort(samples.begin(), samples.end());
+		stat.min = samples.front();
+		stat.median = quantile(0.5);
+		stat.p95 = quantile(0.95);
+		stat.mean = accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+		return stat;
+	}
+
+}
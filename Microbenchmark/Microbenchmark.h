@@ -0,0 +1,123 @@
+////////////////////////////////
+/// usage : 1.  time the hot kernels of the solver in isolation on a single instance,
+///             so that the optimizations can be compared against a stable baseline.
+///
+/// note :  1.  each sample runs the kernel on a freshly prepared input after a few warm-up runs,
+///             and the median and 95th percentile are reported since they are robust to the outliers.
+///         2.  the model cache is cleared before each sample of callModel and buildMixNeigh,
+///             so that the evaluation itself is measured rather than the cache lookup.
+////////////////////////////////
+
+#ifndef MICROBENCHMARK_H
+#define MICROBENCHMARK_H
+
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Solver/Solver.h"
+#include "../Solver/Problem.h"
+#include "../Solver/Utility.h"
+
+
+namespace szx {
+
+	class Microbenchmark {
+#pragma region Type
+	public:
+		using Env = Solver::Environment;
+
+		// elapsed time of a kernel in microseconds.
+		struct Stat {
+			String kernel;
+			String param; // the size or the fill level under test.
+			int sampleNum = 0;
+			double min = 0;
+			double median = 0;
+			double p95 = 0;
+			double mean = 0;
+		};
+#pragma endregion Type
+
+#pragma region Constant
+	public:
+		static constexpr int DefaultSampleNum = 31;
+		static constexpr int WarmUpNum = 3;
+		static constexpr int CacheOpNumPerSample = 1000; // a single cache operation is too short for the clock.
+
+		static String DefaultInstancePath() { return Env::DefaultInstanceDir() + "abs.v1h6c1n100.10.json"; }
+		static String DefaultReportPath() { return "Benchmark/Microbenchmark.csv"; }
+		// the ratio of the customers visited at each period in the random visit matrices.
+		static const std::vector<double>& VisitRates() {
+			static const std::vector<double> rates({ 0.25, 0.5, 0.75 });
+			return rates;
+		}
+		// the customer number in the period node sets for callLKH.
+		static const std::vector<ID>& TourSizes() {
+			static const std::vector<ID> sizes({ 10, 25, 50, 100, 200 });
+			return sizes;
+		}
+		// the tour number in the TSP cache before the lookups.
+		static const std::vector<int>& CacheFillLevels() {
+			static const std::vector<int> levels({ 0, 1000, 10000, 100000 });
+			return levels;
+		}
+#pragma endregion Constant
+
+#pragma region Constructor
+	public:
+		Microbenchmark(const String &instancePath = DefaultInstancePath(), int randSeed = Random::generateSeed(), int sampleNumber = DefaultSampleNum)
+			: env(instancePath, "", randSeed), sampleNum((std::max)(sampleNumber, 1)), rand(randSeed) {}
+		~Microbenchmark();
+#pragma endregion Constructor
+
+#pragma region Method
+	public:
+		// return false if the instance can not be loaded.
+		bool run();
+
+		void print(std::ostream &os) const;
+		// append the statistics to the CSV file and write the header if it is a new file.
+		bool save(const String &path = DefaultReportPath()) const;
+
+	protected:
+		void benchCallModel();
+		void benchCallLkh();
+		void benchTspCache();
+		void benchBuildMixNeigh();
+
+		// draw a visit matrix which the model is feasible on with about `visitRate` of the customers visited at each period.
+		// fall back to the most relaxed one (visit every customer unless it is forbidden) if no feasible one is drawn.
+		void randomFeasibleVisits(VisitMatrix &visits, double visitRate);
+		// the TSP cache entry of `nodeNum` random nodes out of `totalNum` nodes with a dummy tour.
+		void randomNodeSet(CachedTspSolver::TspCache::NodeSet &containNode, CachedTspSolver::Tour &tour, ID totalNum, ID nodeNum);
+
+		// call `prepare(s)` before the `s`_th sample without timing and then time `kernel(s)`.
+		// each sample is divided by `opNum` if the kernel repeats the operation `opNum` times.
+		template<typename Prepare, typename Kernel>
+		void measure(const String &kernel, const String &param, Prepare prepare, Kernel run, int opNum = 1);
+
+		static Stat summarize(const String &kernel, const String &param, std::vector<double> &samples);
+#pragma endregion Method
+
+#pragma region Field
+	public:
+		Env env;
+		int sampleNum;
+
+		std::vector<Stat> stats;
+
+	protected:
+		Random rand;
+		Problem::Input input;
+		Solver::Configuration cfg;
+		std::unique_ptr<Solver> solver;
+#pragma endregion Field
+	}; // Microbenchmark
+
+}
+
+
+#endif // MICROBENCHMARK_H
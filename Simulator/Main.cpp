@@ -8,9 +8,10 @@ int main() {
 
 	Simulator sim;
 	//sim.debug();
-	sim.benchmark(6);
+	sim.benchmark();
 	//sim.parallelBenchmark(4);
 	//sim.generateInstance();
+	//sim.convertAllInstanceFormats();
 
 	return 0;
 }
\ No newline at end of file
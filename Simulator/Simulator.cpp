@@ -3,10 +3,18 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <vector>
 #include <algorithm>
+#include <map>
+#include <set>
+#include <numeric>
 #include <random>
 
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
 
 #include "Simulator.h"
@@ -161,22 +169,220 @@ namespace szx {
 		run(task);
 	}
 
-	void Simulator::benchmark(int repeat) {
-		Task task;
-		task.instSet = "";
+	void Simulator::benchmark(const String &listPath, int workerNum, int jobNumPerRun) {
+		vector<BenchmarkRun> runs;
+		if (!loadBenchmarkList(runs, listPath)) { return; }
+		if (jobNumPerRun <= 0) { jobNumPerRun = 1; }
+		if (workerNum <= 0) { workerNum = max(1, static_cast<int>(thread::hardware_concurrency()) / jobNumPerRun); }
+
+		// prepare the environments in advance since the local time is formatted in a shared buffer.
+		// each run writes its own solution and checkpoint since the seeds of an instance may run at the same time.
+		vector<Env> envs;
+		envs.reserve(runs.size());
+		for (size_t r = 0; r < runs.size(); ++r) {
+			String slnPath(SolutionDir() + runs[r].instId + "." + to_string(runs[r].randSeed) + "." + to_string(r) + ".json");
+			envs.push_back(Env(InstanceDir() + runs[r].instId + ".json", slnPath,
+				runs[r].randSeed, runs[r].timeout, Env::DefaultMaxIter, jobNumPerRun, to_string(r),
+				Env::DefaultCfgPath(), Env::DefaultLogPath()));
+			envs.back().isTspCachePersistent = false; // the runs should neither share tours nor write the same cache file.
+			envs.back().calibrate();
+		}
 
-		task.instId = "abs.v1h6c2n200.6";
-		task.randSeed = "1596309919";
+		{
+			ThreadPool<> tp(workerNum);
+			for (size_t r = 0; r < runs.size(); ++r) {
+				tp.push([&, r]() { runInProcess(runs[r], envs[r], workerNum == 1); });
+			}
+		} // the thread pool waits for all runs in its destructor.
 
-		task.timeout = "600";
-		task.jobNum = "1";
-		task.cfgPath = Env::DefaultCfgPath();
-		task.logPath = Env::DefaultLogPath();
-		for (int i = 0; i < repeat; ++i) {
-			//task.randSeed = to_string(Random::generateSeed());
-			task.runId = to_string(i);
-			run(task);
-			this_thread::sleep_for(1s);
+		reportBenchmark(runs);
+	}
+
+	bool Simulator::loadBenchmarkList(vector<BenchmarkRun> &runs, const String &listPath) {
+		ifstream ifs(listPath);
+		if (!ifs.is_open()) { return false; }
+		CsvReader cr;
+		const vector<CsvReader::Row> &rows(cr.scan(ifs));
+		ifs.close();
+
+		runs.clear();
+		for (auto r = rows.begin(); r != rows.end(); ++r) {
+			if (r == rows.begin()) { continue; } // skip the header.
+			if ((r->size() < 3) || (*r->front() == '\0')) { continue; }
+			BenchmarkRun run;
+			run.instId = r->front();
+			run.timeout = atof((*r)[1]);
+			for (auto seed = r->begin() + 2; seed != r->end(); ++seed) {
+				if (**seed == '\0') { continue; }
+				run.randSeed = atoi(*seed);
+				runs.push_back(run);
+			}
+		}
+		return !runs.empty();
+	}
+
+	void Simulator::runInProcess(BenchmarkRun &run, const Env &env, bool isMemoryMeasured) {
+		// the peak of the process covers the previous runs, so the working set is sampled during the run instead.
+		long long baseMemory = System::memoryUsage().physicalMemory.size;
+		long long peakMemory = baseMemory;
+		mutex sampleMutex;
+		condition_variable sampleCond;
+		bool isDone = false;
+		thread sampler;
+		if (isMemoryMeasured) {
+			sampler = thread([&]() {
+				unique_lock<mutex> sampleLock(sampleMutex);
+				do {
+					peakMemory = max(peakMemory, System::memoryUsage().physicalMemory.size);
+				} while (!sampleCond.wait_for(sampleLock, chrono::milliseconds(MemorySampleIntervalInMillisecond), [&]() { return isDone; }));
+			});
+		}
+		auto stopSampler = [&]() {
+			if (!sampler.joinable()) { return; }
+			{
+				lock_guard<mutex> sampleLock(sampleMutex);
+				isDone = true;
+			}
+			sampleCond.notify_all();
+			sampler.join();
+			run.peakMemory = max(peakMemory, System::memoryUsage().physicalMemory.size) - baseMemory;
+		};
+
+		Solver::Configuration cfg;
+		cfg.load(env.cfgPath);
+
+		Problem::Input input;
+		if (!input.load(env.instPath)) { stopSampler(); return; }
+
+		Solver solver(input, env, cfg);
+		bool isSolved = solver.solve();
+		stopSampler();
+
+		// only the feasible solutions count as solved, and their objectives are taken from the checker.
+		SolutionChecker checker;
+		SolutionChecker::Report report;
+		if (isSolved && checker.check(report, input, solver.output)) { run.obj = report.obj(); }
+		run.timeToBest = Timer::durationInSecond(solver.timer.getStartTime(), solver.bestSlnTime);
+		run.duration = solver.timer.elapsedSeconds();
+		run.improvements = solver.improvements;
+	}
+
+	double Simulator::primalIntegral(const BenchmarkRun &run, double opt) {
+		auto primalGap = [opt](double obj) {
+			double scale = max(abs(obj), abs(opt));
+			return (scale > 0) ? (abs(obj - opt) / scale) : 0;
+		};
+
+		double integral = 0;
+		double prevTime = 0;
+		double prevGap = 1;
+		for (auto i = run.improvements.begin(); i != run.improvements.end(); ++i) {
+			double time = min(i->time, run.timeout);
+			integral += prevGap * (time - prevTime);
+			prevTime = time;
+			prevGap = primalGap(i->cost);
+		}
+		integral += prevGap * max(run.timeout - prevTime, 0.0);
+		return integral;
+	}
+
+	double Simulator::timeToTarget(const BenchmarkRun &run, double opt, double targetGap) {
+		for (auto i = run.improvements.begin(); i != run.improvements.end(); ++i) {
+			if (i->cost <= opt * (1 + targetGap) + Math::DefaultTolerance) { return i->time; }
+		}
+		return -1;
+	}
+
+	void Simulator::reportBenchmark(const vector<BenchmarkRun> &runs) {
+		// load reference results.
+		map<String, pair<double, double>> baselines; // the B&C and HAIR objectives of each instance.
+		ifstream ifs(BaselinePath());
+		if (ifs.is_open()) {
+			CsvReader cr;
+			const vector<CsvReader::Row> &rows(cr.scan(ifs));
+			for (auto r = rows.begin(); r != rows.end(); ++r) {
+				if (r->size() < 3) { continue; }
+				baselines[r->front()] = make_pair(atof((*r)[1]), atof((*r)[2]));
+			}
+			ifs.close();
+		}
+
+		auto gap = [](double obj, double ref) { return (ref > 0) ? (100 * (obj - ref) / ref) : 0; };
+
+		System::makeSureDirExist(BenchmarkReportDir());
+		String reportPath = BenchmarkReportDir() + Timer::getTightLocalTime();
+
+		ofstream runLog(reportPath + ".runs.csv");
+		runLog << "Instance,Seed,Obj,TimeToBest,Duration,PeakMemory,B&C,GapToB&C(%),HAIR,GapToHAIR(%)" << endl;
+		vector<String> instIds; // in the order of appearance.
+		map<String, vector<const BenchmarkRun*>> instRuns;
+		for (auto r = runs.begin(); r != runs.end(); ++r) {
+			const pair<double, double> &ref(baselines[r->instId]);
+			runLog << r->instId << "," << r->randSeed << "," << r->obj << ","
+				<< r->timeToBest << "," << r->duration << "," << r->peakMemory << ","
+				<< ref.first << "," << gap(r->obj, ref.first) << ","
+				<< ref.second << "," << gap(r->obj, ref.second) << endl;
+
+			auto &solvedRuns(instRuns[r->instId]);
+			if (find(instIds.begin(), instIds.end(), r->instId) == instIds.end()) { instIds.push_back(r->instId); }
+			if (r->obj >= 0) { solvedRuns.push_back(&*r); }
+		}
+
+		ofstream summary(reportPath + ".summary.csv");
+		summary << "Instance,SolvedRunNum,MeanObj,BestObj,MeanTimeToBest,B&C,MeanGapToB&C(%),BestGapToB&C(%),HAIR,MeanGapToHAIR(%),BestGapToHAIR(%)" << endl;
+		for (auto i = instIds.begin(); i != instIds.end(); ++i) {
+			const vector<const BenchmarkRun*> &solvedRuns(instRuns[*i]);
+			const pair<double, double> &ref(baselines[*i]);
+			summary << *i << "," << solvedRuns.size();
+			if (solvedRuns.empty()) { summary << endl; continue; }
+
+			double meanObj = 0;
+			double bestObj = solvedRuns.front()->obj;
+			double meanTimeToBest = 0;
+			for (auto r = solvedRuns.begin(); r != solvedRuns.end(); ++r) {
+				meanObj += (*r)->obj;
+				bestObj = min(bestObj, (*r)->obj);
+				meanTimeToBest += (*r)->timeToBest;
+			}
+			meanObj /= solvedRuns.size();
+			meanTimeToBest /= solvedRuns.size();
+
+			summary << "," << meanObj << "," << bestObj << "," << meanTimeToBest << ","
+				<< ref.first << "," << gap(meanObj, ref.first) << "," << gap(bestObj, ref.first) << ","
+				<< ref.second << "," << gap(meanObj, ref.second) << "," << gap(bestObj, ref.second) << endl;
+		}
+
+		// anytime profile against the B&C optima.
+		// each row of the time-to-target file is a point on the empirical distribution of the time to reach the target.
+		ofstream tttLog(reportPath + ".ttt.csv");
+		tttLog << "Instance,TargetGap(%),Seed,TimeToTarget" << endl;
+		ofstream profile(reportPath + ".profile.csv");
+		profile << "Instance,RunNum,B&C,MeanPrimalIntegral";
+		for (double target : TargetGaps()) { profile << ",HitRate@" << 100 * target << "%,MeanTime@" << 100 * target << "%"; }
+		profile << endl;
+		for (auto i = instIds.begin(); i != instIds.end(); ++i) {
+			double opt = baselines[*i].first;
+			if (opt <= 0) { continue; }
+			vector<const BenchmarkRun*> instAllRuns;
+			for (auto r = runs.begin(); r != runs.end(); ++r) { if (r->instId == *i) { instAllRuns.push_back(&*r); } }
+
+			double meanIntegral = 0;
+			for (auto r = instAllRuns.begin(); r != instAllRuns.end(); ++r) { meanIntegral += primalIntegral(**r, opt); }
+			meanIntegral /= instAllRuns.size();
+			profile << *i << "," << instAllRuns.size() << "," << opt << "," << meanIntegral;
+
+			for (double target : TargetGaps()) {
+				vector<double> times;
+				for (auto r = instAllRuns.begin(); r != instAllRuns.end(); ++r) {
+					double time = timeToTarget(**r, opt, target);
+					if (time < 0) { continue; }
+					times.push_back(time);
+					tttLog << *i << "," << 100 * target << "," << (*r)->randSeed << "," << time << endl;
+				}
+				double meanTime = times.empty() ? -1 : (accumulate(times.begin(), times.end(), 0.0) / times.size());
+				profile << "," << (static_cast<double>(times.size()) / instAllRuns.size()) << "," << meanTime;
+			}
+			profile << endl;
 		}
 	}
 
@@ -283,4 +489,22 @@ namespace szx {
 		}
 	}
 
+	bool Simulator::convertInstanceFormat(const String &instId, const String &srcExt, const String &dstExt) {
+		Problem::Input input;
+		if (!input.load(InstanceDir() + instId + srcExt)) { return false; }
+		return save(InstanceDir() + instId + dstExt, input);
+	}
+
+	void Simulator::convertAllInstanceFormats(const String &srcExt, const String &dstExt) {
+		set<String> instIds(instList.begin(), instList.end());
+		vector<BenchmarkRun> runs;
+		if (loadBenchmarkList(runs, BenchmarkListPath())) {
+			for (auto r = runs.begin(); r != runs.end(); ++r) { instIds.insert(r->instId); }
+		}
+
+		for (auto i = instIds.begin(); i != instIds.end(); ++i) {
+			if (!convertInstanceFormat(*i, srcExt, dstExt)) { cerr << "fail to convert " << *i << srcExt << endl; }
+		}
+	}
+
 }
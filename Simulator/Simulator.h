@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "../Solver/Solver.h"
+#include "../Solver/CsvReader.h"
 #include "../Solver/Problem.h"
 #include "../Solver/Utility.h"
 
@@ -42,6 +43,18 @@ namespace szx {
 			String runId;
 		};
 
+		struct BenchmarkRun {
+			String instId;
+			int randSeed = 0;
+			double timeout = 0;
+
+			double obj = -1; // negative if the instance is not solved or the solution is infeasible.
+			double timeToBest = 0;
+			double duration = 0;
+			long long peakMemory = -1; // peak physical memory in bytes taken by the run, or -1 if it shares the process with other runs.
+			std::vector<Solver::Improvement> improvements; // anytime profile.
+		};
+
 		struct InstanceTrait {
 			int depotNum = 1;
 			int vehicleNum = 1;
@@ -53,6 +66,18 @@ namespace szx {
 	public:
 		static String InstanceDir() { return Env::DefaultInstanceDir(); }
 		static String SolutionDir() { return Env::DefaultSolutionDir(); }
+		// each row is "instance,timeout,seed1,seed2,..." after the header row.
+		static String BenchmarkListPath() { return InstanceDir() + "BenchmarkList.csv"; }
+		// each row is "instance,B&C,HAIR,HairTime" after the header row.
+		static String BaselinePath() { return InstanceDir() + "Baseline.csv"; }
+		static String BenchmarkReportDir() { return "Benchmark/"; }
+		// the working set of a benchmark run is sampled at this interval to find its peak.
+		static constexpr int MemorySampleIntervalInMillisecond = 50;
+		// relative gaps to the optimum for the time-to-target statistics.
+		static const std::vector<double>& TargetGaps() {
+			static const std::vector<double> gaps({ 0.05, 0.02, 0.01, 0.005, 0.0 });
+			return gaps;
+		}
 
 		//static String ProgramName() { return "Simulator.exe";  }
 		static String ProgramName() { return "Solver.exe"; }
@@ -81,8 +106,9 @@ namespace szx {
 
 		// utility for debugging solver with certain arguments.
 		void debug();
-		// utility for testing all instances.
-		void benchmark(int repeat = 1);
+		// utility for testing the instances with the seeds in the list in process, `workerNum` runs at the same time.
+		// the runs and the mean and best results over the seeds of each instance are compared with the baseline.
+		void benchmark(const String &listPath = BenchmarkListPath(), int workerNum = 0, int jobNumPerRun = 1);
 		// utility for testing all instances using a thread pool.
 		void parallelBenchmark(int repeat);
 
@@ -90,6 +116,20 @@ namespace szx {
 		void generateInstance(const InstanceTrait &trait = InstanceTrait());
 		static void convertInstanceToPb(const String &filePath, const InstanceTrait &trait = InstanceTrait());
 		static void convertAllInstancesToPb(const InstanceTrait &trait = InstanceTrait());
+		// re-encode the instance `instId` in the instance directory from one format to another by the file extensions.
+		static bool convertInstanceFormat(const String &instId, const String &srcExt = FileExtension::json(), const String &dstExt = FileExtension::protobuf());
+		// re-encode the instances in the instance list and the benchmark list.
+		static void convertAllInstanceFormats(const String &srcExt = FileExtension::json(), const String &dstExt = FileExtension::protobuf());
+
+	protected:
+		static bool loadBenchmarkList(std::vector<BenchmarkRun> &runs, const String &listPath);
+		// the memory is measured only if `isMemoryMeasured` is true, which requires that no other run is going on.
+		static void runInProcess(BenchmarkRun &run, const Env &env, bool isMemoryMeasured);
+		static void reportBenchmark(const std::vector<BenchmarkRun> &runs);
+		// the primal gap is 1 before the first solution and |obj - opt| / max(|obj|, |opt|) after it.
+		static double primalIntegral(const BenchmarkRun &run, double opt);
+		// return -1 if the target is never reached.
+		static double timeToTarget(const BenchmarkRun &run, double opt, double targetGap);
 #pragma endregion Method
 
 #pragma region Field
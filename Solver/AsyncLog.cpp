@@ -0,0 +1,75 @@
+#include "AsyncLog.h"
+
+#include <algorithm>
+
+
+using namespace std;
+
+
+namespace szx {
+
+AsyncLog::~AsyncLog() {
+    {
+        lock_guard<mutex> stopLock(stopMutex);
+        isStopped = true;
+    }
+    stopCond.notify_all();
+    if (flusher.joinable()) { flusher.join(); }
+    flush();
+}
+
+void AsyncLog::flush() {
+    lock_guard<mutex> drainLock(drainMutex);
+    long long dropNum = 0;
+    {
+        lock_guard<mutex> ringLock(ringMutex);
+        for (auto r = rings.begin(); r != rings.end(); ++r) {
+            (*r)->popAll(batch);
+            dropNum += (*r)->dropNum.load(memory_order_relaxed);
+        }
+    }
+    if (batch.empty() && (dropNum == reportedDropNum)) { return; }
+
+    // the rings are drained one by one, so the records of different threads are interleaved here.
+    stable_sort(batch.begin(), batch.end(), [](const Record &l, const Record &r) { return l.nanosecond < r.nanosecond; });
+    long long epochNs = epoch.load(memory_order_relaxed);
+    buffer.str("");
+    for (auto r = batch.begin(); r != batch.end(); ++r) {
+        buffer << "t=" << ((r->nanosecond - epochNs) / 1e9) << " worker=" << r->worker
+            << " phase=" << phaseName(r->phase) << " event=" << r->event << " cost=" << r->cost;
+        if (r->arg != NoArg) { buffer << " arg=" << r->arg; }
+        buffer << '\n';
+    }
+    if (dropNum > reportedDropNum) {
+        buffer << "dropped " << (dropNum - reportedDropNum) << " records for full rings.\n";
+        reportedDropNum = dropNum;
+    }
+    batch.clear();
+
+    os << buffer.str();
+    os.flush();
+}
+
+AsyncLog::Ring* AsyncLog::acquireRing() {
+    lock_guard<mutex> ringLock(ringMutex);
+    if (!flusher.joinable()) { flusher = thread([this]() { flushLoop(); }); }
+    for (auto r = rings.begin(); r != rings.end(); ++r) {
+        bool released = false;
+        if ((*r)->inUse.compare_exchange_strong(released, true, memory_order_acquire)) { return r->get(); }
+    }
+    rings.emplace_back(new Ring());
+    rings.back()->inUse = true;
+    return rings.back().get();
+}
+
+void AsyncLog::flushLoop() {
+    unique_lock<mutex> stopLock(stopMutex);
+    while (!isStopped) {
+        stopCond.wait_for(stopLock, chrono::milliseconds(FlushIntervalInMillisecond));
+        stopLock.unlock();
+        flush();
+        stopLock.lock();
+    }
+}
+
+}
@@ -0,0 +1,170 @@
+////////////////////////////////
+/// usage : 1.	record structured search events (timestamp, worker, phase, event, cost) from the hot paths.
+///         2.	the records are drained and written by a background thread, so the search thread never formats or flushes.
+///
+/// note  : 1.	each thread writes to its own single-producer ring, and the records are dropped and counted if the ring is full.
+///         2.	the records of a thread are tagged with the worker bound by `Binding`, or -1 if there is none.
+///         3.	call `flush()` to write all pending records before reading the log.
+////////////////////////////////
+
+#ifndef SMART_SZX_INVENTORY_ROUTING_ASYNC_LOG_H
+#define SMART_SZX_INVENTORY_ROUTING_ASYNC_LOG_H
+
+
+#include "Config.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Utility.h"
+
+
+namespace szx {
+
+class AsyncLog {
+public:
+    enum Phase { Disturb, TabuSearch, Model, Window, Elite, PhaseNum };
+
+    using Clock = std::chrono::steady_clock;
+
+
+    static const char* phaseName(Phase phase) {
+        static const char *names[PhaseNum] = { "disturb", "tabuSearch", "model", "window", "elite" };
+        return names[phase];
+    }
+
+    static constexpr int NoArg = -1;
+
+    struct Record {
+        long long nanosecond; // since the epoch of the clock.
+        int worker;
+        Phase phase;
+        const char *event; // must be a string literal since it is read after the call returns.
+        double cost;
+        int arg; // an optional integer such as the period, or `NoArg`.
+    };
+
+    // the owner thread pushes the records while the flusher pops them.
+    struct Ring {
+        static constexpr unsigned Capacity = (1 << 10); // must be a power of 2.
+        static constexpr unsigned Mask = Capacity - 1;
+
+        Ring() : head(0), tail(0), inUse(false), dropNum(0) {}
+
+        bool push(const Record &record) {
+            unsigned h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) >= Capacity) {
+                dropNum.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            records[h & Mask] = record;
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        void popAll(std::vector<Record> &out) {
+            unsigned t = tail.load(std::memory_order_relaxed);
+            unsigned h = head.load(std::memory_order_acquire);
+            for (; t != h; ++t) { out.push_back(records[t & Mask]); }
+            tail.store(t, std::memory_order_release);
+        }
+
+        Record records[Capacity];
+        std::atomic<unsigned> head; // written by the owner only.
+        char padding[64]; // keep the owner and the flusher off the same cache line.
+        std::atomic<unsigned> tail; // written by the flusher only.
+        std::atomic<bool> inUse; // a released ring is handed to the next new thread.
+        std::atomic<long long> dropNum;
+    };
+
+    // tag the records in the current thread with the worker until the binding is destructed.
+    class Binding {
+    public:
+        Binding(int workerId) : prevWorker(boundWorker()) { boundWorker() = workerId; }
+        ~Binding() { boundWorker() = prevWorker; }
+
+    protected:
+        int prevWorker;
+    };
+
+
+    static constexpr int FlushIntervalInMillisecond = 100;
+
+
+    static AsyncLog& instance() {
+        static AsyncLog log(std::cerr);
+        return log;
+    }
+
+    static int& boundWorker() {
+        static thread_local int workerId = -1;
+        return workerId;
+    }
+
+    // it never blocks or allocates except for the first record of a thread.
+    static void write(int level, Phase phase, const char *event, double cost, int arg = NoArg) {
+        if (Log::isTurnedOff(level)) { return; }
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+        localRing()->push({ ns, boundWorker(), phase, event, cost, arg });
+    }
+
+
+    AsyncLog(std::ostream &logFile) : os(logFile), epoch(0), isStopped(false) { restart(); }
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+    ~AsyncLog();
+
+    // the timestamps in the output are measured from the last restart.
+    void restart() {
+        epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    // write the pending records of all threads in the order of their timestamps.
+    void flush();
+
+protected:
+    // release the ring of the thread on exit.
+    struct RingHandle {
+        ~RingHandle() { if (ring) { ring->inUse.store(false, std::memory_order_release); } }
+
+        Ring *ring = nullptr;
+    };
+
+    static Ring* localRing() {
+        static thread_local RingHandle handle;
+        if (!handle.ring) { handle.ring = instance().acquireRing(); }
+        return handle.ring;
+    }
+
+    Ring* acquireRing();
+    void flushLoop();
+
+
+    std::ostream &os;
+    std::atomic<long long> epoch;
+
+    std::mutex ringMutex; // guard `rings` and the flusher startup.
+    std::vector<std::unique_ptr<Ring>> rings; // a ring is never freed until the log is destructed.
+    std::thread flusher;
+
+    std::mutex drainMutex; // serialize the consumers of the rings.
+    std::vector<Record> batch;
+    std::ostringstream buffer;
+    long long reportedDropNum = 0;
+
+    std::mutex stopMutex;
+    std::condition_variable stopCond;
+    bool isStopped;
+};
+
+}
+
+
+#endif // SMART_SZX_INVENTORY_ROUTING_ASYNC_LOG_H
@@ -0,0 +1,49 @@
+#include "InstanceView.h"
+
+
+using namespace std;
+
+
+namespace szx {
+
+void InstanceView::init(const Input &input) {
+    periodNumber = input.periodnum();
+    nodeNumber = input.nodes_size();
+    depotNumber = input.depotnum();
+    vehicleNumber = input.vehicles_size();
+    rowLen = paddedLen<Quantity>(nodeNumber);
+
+    xs.init(nodeNumber);
+    ys.init(nodeNumber);
+    capacities.init(nodeNumber);
+    minLevels.init(nodeNumber);
+    initQuantities.init(nodeNumber);
+    holdingCosts.init(nodeNumber);
+    demands.init(periodNumber * rowLen);
+    cumDemands.init((periodNumber + 1) * rowLen);
+    ID n = 0;
+    for (auto i = input.nodes().begin(); i != input.nodes().end(); ++i, ++n) {
+        xs[n] = i->x();
+        ys[n] = i->y();
+        capacities[n] = i->capacity();
+        minLevels[n] = i->minlevel();
+        initQuantities[n] = i->initquantity();
+        holdingCosts[n] = i->holdingcost();
+        for (ID p = 0; p < periodNumber; ++p) {
+            demands[p * rowLen + n] = i->demands(p);
+            cumDemands[(p + 1) * rowLen + n] = cumDemands[p * rowLen + n] + i->demands(p);
+        }
+    }
+
+    vehicleCapacities.init(vehicleNumber);
+    deliveryCapacities.init(vehicleNumber * rowLen);
+    ID v = 0;
+    for (auto i = input.vehicles().begin(); i != input.vehicles().end(); ++i, ++v) {
+        vehicleCapacities[v] = i->capacity();
+        for (n = 0; n < nodeNumber; ++n) {
+            deliveryCapacities[v * rowLen + n] = (min)(vehicleCapacities[v], capacities[n]);
+        }
+    }
+}
+
+}
@@ -0,0 +1,141 @@
+////////////////////////////////
+/// usage : 1.	flat read-only copy of the instance data in structure-of-arrays layout for the hot loops of the solver.
+///
+/// note  : 1.	it is built once from the protobuf input and never changes afterwards, so it can be shared by all workers.
+///         2.	every array starts at a cache line, and each period row of the demand matrices is padded to a cache line too.
+///         3.	`cumDemand(p, n)` is the total demand of node n in periods [0, p), so the demand in [p1, p2) is a subtraction.
+////////////////////////////////
+
+#ifndef SMART_SZX_INVENTORY_ROUTING_INSTANCE_VIEW_H
+#define SMART_SZX_INVENTORY_ROUTING_INSTANCE_VIEW_H
+
+
+#include "Config.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "Common.h"
+#include "InventoryRouting.pb.h"
+
+
+namespace szx {
+
+class InstanceView {
+public:
+    using Input = pb::InventoryRouting::Input;
+
+
+    static constexpr size_t Alignment = 64; // bytes of a cache line.
+
+
+    // fixed size array whose first item is aligned to `Alignment`.
+    template<typename T>
+    class AlignedArr {
+    public:
+        AlignedArr() : arr(nullptr), len(0) {}
+        AlignedArr(const AlignedArr&) = delete;
+        AlignedArr& operator=(const AlignedArr&) = delete;
+        ~AlignedArr() { release(); }
+
+        // the items are zero-initialized.
+        void init(ID length) {
+            release();
+            len = length;
+            if (len <= 0) { return; }
+            size_t byteNum = roundUp(sizeof(T) * len);
+            #if _OS_MS_WINDOWS
+            arr = static_cast<T*>(_aligned_malloc(byteNum, Alignment));
+            #else
+            void *p = nullptr;
+            arr = (posix_memalign(&p, Alignment, byteNum) == 0) ? static_cast<T*>(p) : nullptr;
+            #endif // _OS_MS_WINDOWS
+            if (arr == nullptr) { throw std::bad_alloc(); }
+            std::fill(arr, arr + len, T());
+        }
+
+        T& operator[](ID i) { return arr[i]; }
+        const T& operator[](ID i) const { return arr[i]; }
+        T* data() { return arr; }
+        const T* data() const { return arr; }
+        ID size() const { return len; }
+
+    protected:
+        void release() {
+            #if _OS_MS_WINDOWS
+            _aligned_free(arr);
+            #else
+            free(arr);
+            #endif // _OS_MS_WINDOWS
+            arr = nullptr;
+            len = 0;
+        }
+
+
+        T *arr;
+        ID len;
+    };
+
+
+    static size_t roundUp(size_t byteNum) { return (byteNum + Alignment - 1) / Alignment * Alignment; }
+    // number of items in a row padded to whole cache lines.
+    template<typename T>
+    static ID paddedLen(ID len) { return static_cast<ID>(roundUp(sizeof(T) * len) / sizeof(T)); }
+
+
+    InstanceView() : periodNumber(0), nodeNumber(0), depotNumber(0), vehicleNumber(0), rowLen(0) {}
+    InstanceView(const InstanceView&) = delete;
+    InstanceView& operator=(const InstanceView&) = delete;
+
+    void init(const Input &input);
+
+    ID periodNum() const { return periodNumber; }
+    ID nodeNum() const { return nodeNumber; }
+    ID depotNum() const { return depotNumber; }
+    ID vehicleNum() const { return vehicleNumber; }
+    bool isDepot(ID n) const { return n < depotNumber; }
+
+    double x(ID n) const { return xs[n]; }
+    double y(ID n) const { return ys[n]; }
+    Quantity capacity(ID n) const { return capacities[n]; }
+    Quantity minLevel(ID n) const { return minLevels[n]; }
+    Quantity initQuantity(ID n) const { return initQuantities[n]; }
+    Price holdingCost(ID n) const { return holdingCosts[n]; }
+
+    Quantity demand(ID p, ID n) const { return demands[p * rowLen + n]; }
+    Quantity cumDemand(ID p, ID n) const { return cumDemands[p * rowLen + n]; }
+    // the demands of all nodes at period p.
+    const Quantity* demandRow(ID p) const { return demands.data() + p * rowLen; }
+
+    Quantity vehicleCapacity(ID v) const { return vehicleCapacities[v]; }
+    // max quantity vehicle v can deliver to (or pick up from) node n in a single visit.
+    Quantity deliveryCapacity(ID v, ID n) const { return deliveryCapacities[v * rowLen + n]; }
+
+    // contiguous arrays for the loops over all nodes.
+    const Quantity* capacityData() const { return capacities.data(); }
+    const Price* holdingCostData() const { return holdingCosts.data(); }
+
+protected:
+    ID periodNumber;
+    ID nodeNumber;
+    ID depotNumber;
+    ID vehicleNumber;
+    ID rowLen; // padded length of a row in the matrices indexed by node.
+
+    AlignedArr<double> xs;
+    AlignedArr<double> ys;
+    AlignedArr<Quantity> capacities;
+    AlignedArr<Quantity> minLevels;
+    AlignedArr<Quantity> initQuantities;
+    AlignedArr<Price> holdingCosts;
+    AlignedArr<Quantity> demands; // periodNum rows.
+    AlignedArr<Quantity> cumDemands; // (periodNum + 1) rows.
+    AlignedArr<Quantity> vehicleCapacities;
+    AlignedArr<Quantity> deliveryCapacities; // vehicleNum rows.
+};
+
+}
+
+
+#endif // SMART_SZX_INVENTORY_ROUTING_INSTANCE_VIEW_H
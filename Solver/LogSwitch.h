@@ -30,6 +30,19 @@ namespace szx {
 			Opt = Log::Level::On,
 		};
 
+		// switches for the hot spot probes in Profiler.
+		struct Prof {
+			enum Switch {
+				Model = Log::Level::On, // callModel().
+				Cache = Log::Level::On, // model cache lookups.
+				Lkh = Log::Level::On, // callLKH() and callLKH4Cost().
+				Neighborhood = Log::Level::On, // buildMixNeigh().
+				Disturb = Log::Level::On,
+				MipCallback = Log::Level::On, // solution and progress callbacks of the MIP models.
+				Summary = Log::Level::On, // print the table at the end of Solver::solve().
+			};
+		};
+
 		//enum Szx {
 		//	Main = Log::Level::Info,
 		//	Cli = Log::Level::Off,
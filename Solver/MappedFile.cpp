@@ -0,0 +1,62 @@
+#include "MappedFile.h"
+
+#if _OS_MS_WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _OS_MS_WINDOWS
+
+
+using namespace std;
+
+
+namespace szx {
+
+bool MappedFile::open(const string &path) {
+    close();
+
+    // the mapping is kept alive by the view, so the handles are closed right after mapping.
+    #if _OS_MS_WINDOWS
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) { CloseHandle(file); return false; }
+    byteNum = static_cast<size_t>(fileSize.QuadPart);
+    if (byteNum == 0) { CloseHandle(file); return true; } // an empty file can not be mapped.
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) { byteNum = 0; return false; }
+    begin = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    #else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { return false; }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) { ::close(fd); return false; }
+    byteNum = static_cast<size_t>(fileStat.st_size);
+    if (byteNum == 0) { ::close(fd); return true; } // an empty file can not be mapped.
+    void *addr = mmap(nullptr, byteNum, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    begin = (addr == MAP_FAILED) ? nullptr : static_cast<const char*>(addr);
+    #endif // _OS_MS_WINDOWS
+
+    if (begin == nullptr) { byteNum = 0; return false; }
+    return true;
+}
+
+void MappedFile::close() {
+    if (begin != nullptr) {
+        #if _OS_MS_WINDOWS
+        UnmapViewOfFile(begin);
+        #else
+        munmap(const_cast<char*>(begin), byteNum);
+        #endif // _OS_MS_WINDOWS
+    }
+    begin = nullptr;
+    byteNum = 0;
+}
+
+}
@@ -0,0 +1,42 @@
+////////////////////////////////
+/// usage : 1.	map a whole file into the address space as read-only memory.
+///
+/// note  : 1.	the content is paged in on demand, so parsing directly from it avoids the copy into a string buffer.
+///         2.	an empty file is opened successfully with a null `data()`.
+////////////////////////////////
+
+#ifndef SMART_SZX_INVENTORY_ROUTING_MAPPED_FILE_H
+#define SMART_SZX_INVENTORY_ROUTING_MAPPED_FILE_H
+
+
+#include "Config.h"
+
+#include <string>
+
+
+namespace szx {
+
+class MappedFile {
+public:
+    MappedFile() : begin(nullptr), byteNum(0) {}
+    MappedFile(const std::string &path) : MappedFile() { open(path); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    // return false if the file can not be opened or mapped.
+    bool open(const std::string &path);
+    void close();
+
+    const char* data() const { return begin; }
+    size_t size() const { return byteNum; }
+
+protected:
+    const char *begin;
+    size_t byteNum;
+};
+
+}
+
+
+#endif // SMART_SZX_INVENTORY_ROUTING_MAPPED_FILE_H
@@ -0,0 +1,103 @@
+////////////////////////////////
+/// usage : 1.	cache for the holding cost of the inventory model under given visit patterns.
+///
+/// note  : 1.	entries are keyed by the 64-bit signature of the visit matrix.
+///         2.	feasible entries are evicted in insertion order when the capacity is reached,
+///         	while infeasible signatures are kept forever since they are tiny and expensive to prove.
+////////////////////////////////
+
+#ifndef SMART_SZX_INVENTORY_ROUTING_MODEL_CACHE_H
+#define SMART_SZX_INVENTORY_ROUTING_MODEL_CACHE_H
+
+
+#include "Config.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Common.h"
+#include "VisitMatrix.h"
+
+
+namespace szx {
+
+class ModelCache {
+public:
+    using Signature = VisitMatrix::Word;
+
+
+    static constexpr Price Infeasible = -1;
+    static constexpr size_t DefaultCapacity = (1 << 16);
+
+
+    ModelCache(size_t maxEntryNum = DefaultCapacity) : capacity(maxEntryNum), hitNum(0), missNum(0) {}
+
+    // return true and set `cost` if the visit pattern has been evaluated.
+    // `cost` is `Infeasible` if the model has no solution under the visit pattern.
+    bool get(Price &cost, Signature key) const {
+        std::lock_guard<std::mutex> guard(cacheMutex);
+        if (infeasibles.find(key) != infeasibles.end()) {
+            ++hitNum;
+            cost = Infeasible;
+            return true;
+        }
+        auto entry = costs.find(key);
+        if (entry == costs.end()) { ++missNum; return false; }
+        ++hitNum;
+        cost = entry->second;
+        return true;
+    }
+
+    void set(Signature key, Price cost) {
+        std::lock_guard<std::mutex> guard(cacheMutex);
+        if (cost < 0) { infeasibles.insert(key); return; }
+        if (capacity == 0) { return; }
+        if (!costs.emplace(key, cost).second) { return; }
+        insertionOrder.push_back(key);
+        while (insertionOrder.size() > capacity) {
+            costs.erase(insertionOrder.front());
+            insertionOrder.pop_front();
+        }
+    }
+
+    // shrinking the capacity takes effect on the next insertion.
+    void setCapacity(size_t maxEntryNum) {
+        std::lock_guard<std::mutex> guard(cacheMutex);
+        capacity = maxEntryNum;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> guard(cacheMutex);
+        costs.clear();
+        infeasibles.clear();
+        insertionOrder.clear();
+        hitNum = 0;
+        missNum = 0;
+    }
+
+    long long getHitNum() const { return hitNum; }
+    long long getMissNum() const { return missNum; }
+    size_t size() const {
+        std::lock_guard<std::mutex> guard(cacheMutex);
+        return costs.size() + infeasibles.size();
+    }
+
+protected:
+    size_t capacity; // max number of feasible entries.
+
+    std::unordered_map<Signature, Price> costs;
+    std::unordered_set<Signature> infeasibles;
+    std::deque<Signature> insertionOrder;
+
+    mutable std::atomic<long long> hitNum;
+    mutable std::atomic<long long> missNum;
+    mutable std::mutex cacheMutex;
+};
+
+}
+
+
+#endif // SMART_SZX_INVENTORY_ROUTING_MODEL_CACHE_H
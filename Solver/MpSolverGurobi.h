@@ -146,6 +146,8 @@ public:
     using OnOptimaFound = std::function<bool(MpSolverGurobi&, std::function<bool(void)>)>;
     // on finding an MIP solution during optimization.
     using OnMipSln = std::function<void(MpEvent&)>;
+    // on reporting the progress periodically during the branch-and-bound.
+    using OnMipProgress = std::function<void(MpEvent&)>;
 
     struct Configuration {
         static constexpr InternalSolver DefaultSolver = InternalSolver::GurobiMip;
@@ -193,8 +195,8 @@ public:
     protected:
         friend MpSolverGurobi;
 
-        MpEvent(OnMipSln onMipSolutionFound = OnMipSln())
-            : onMipSln(onMipSolutionFound) {}
+        MpEvent(OnMipSln onMipSolutionFound = OnMipSln(), OnMipProgress onMipProgressReported = OnMipProgress())
+            : onMipSln(onMipSolutionFound), onMipProgress(onMipProgressReported) {}
 
     public:
         using GRBCallback::addCut;
@@ -220,24 +222,26 @@ public:
         double getBestObj() {
             switch (where) {
             case GRB_CB_MIP:
-                getDoubleInfo(GRB_CB_MIP_OBJBST);
-                break;
+                return getDoubleInfo(GRB_CB_MIP_OBJBST);
             case GRB_CB_MIPNODE:
-                getDoubleInfo(GRB_CB_MIPNODE_OBJBST);
-                break;
+                return getDoubleInfo(GRB_CB_MIPNODE_OBJBST);
             case GRB_CB_MIPSOL:
-                getDoubleInfo(GRB_CB_MIPSOL_OBJBST);
-                break;
+                return getDoubleInfo(GRB_CB_MIPSOL_OBJBST);
             }
+            return GRB_INFINITY;
         }
+        double getRuntimeInSecond() { return getDoubleInfo(GRB_CB_RUNTIME); }
 
         void callback() {
             if (where == GRB_CB_MIPSOL) {
                 if (onMipSln) { onMipSln(*this); }
+            } else if (where == GRB_CB_MIP) {
+                if (onMipProgress) { onMipProgress(*this); }
             }
         }
 
         OnMipSln onMipSln;
+        OnMipProgress onMipProgress;
     };
     #pragma endregion Type
 
@@ -302,6 +306,9 @@ public:
         setAltSolutionIndex(solutionIndex);
         return var.get(GRB_DoubleAttr_Xn);
     }
+    // select the alternative solution once and read it by `getAltValue(var)` to avoid resetting the index for each variable.
+    void selectAltSolution(int solutionIndex) { setAltSolutionIndex(solutionIndex); }
+    double getAltValue(const DecisionVar &var) const { return var.get(GRB_DoubleAttr_Xn); }
 
     using MpSolverBase::isTrue;
     bool isTrue(LinearExpr expr) const { return isTrue(getValue(expr)); }
@@ -328,6 +335,8 @@ public:
     // constraints.
     Constraint addConstraint(const LinearRange &r, const String &name = "") { return model.addConstr(r, name); }
     void removeConstraint(Constraint constraint) { model.remove(constraint); }
+    // the dual value (shadow price) of a constraint in the optimal solution of a continuous model.
+    double getDualValue(const Constraint &constraint) const { return constraint.get(GRB_DoubleAttr_Pi); }
     int getConstraintCount() const { return model.get(GRB_IntAttr_NumConstrs); }
 
     // objectives.
@@ -376,6 +385,11 @@ public:
         mpEvent.onMipSln = onMipSln;
         model.setCallback(&mpEvent);
     }
+    // the handler may call MpEvent::stop() to terminate the optimization early (e.g., on stagnation).
+    void setMipProgressEvent(OnMipProgress onMipProgress) {
+        mpEvent.onMipProgress = onMipProgress;
+        model.setCallback(&mpEvent);
+    }
 
     // [Tune] use the given value as the initial solution in MIP.
     void setInitValue(DecisionVar &var, double value) { var.set(GRB_DoubleAttr_Start, value); }
@@ -1,7 +1,10 @@
 ////////////////////////////////
 /// usage : 1.	data format converters.
 /// 
-/// note  : 1.	
+/// note  : 1.	the binary protobuf format is used if the file path ends with `FileExtension::protobuf()`,
+///         	otherwise the JSON format is used.
+///         2.	a file with a header (e.g., a solution with its submission) is a JSON line followed by the JSON body
+///         	or two length-delimited messages in the binary format.
 ////////////////////////////////
 
 #ifndef SMART_SZX_INVENTORY_ROUTING_PB_READER_H
@@ -12,11 +15,18 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <limits>
 
 #pragma warning(push, 0)
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/util/delimited_message_util.h"
 #include "google/protobuf/util/json_util.h"
 #pragma warning(pop)
 
+#include "Common.h"
+#include "MappedFile.h"
+#include "Utility.h"
+
 
 namespace pb {
 
@@ -40,8 +50,26 @@ void jsonToProtobuf(const std::string &data, T &obj) {
     google::protobuf::util::JsonStringToMessage(data, &obj, options);
 }
 
+inline bool isBinaryPath(const std::string &path) {
+    const std::string &ext(szx::FileExtension::protobuf());
+    return (path.size() >= ext.size()) && (path.compare(path.size() - ext.size(), ext.size(), ext) == 0);
+}
+
+// parse from the mapped file without copying it into a string buffer.
+// the coded stream is limited to 2GB, which is far beyond the largest instance.
+inline bool mapFile(szx::MappedFile &file, const std::string &path) {
+    return file.open(path) && (file.size() <= static_cast<size_t>((std::numeric_limits<int>::max)()));
+}
+
 template<typename T>
 static bool load(const std::string &path, T &obj) {
+    if (isBinaryPath(path)) {
+        szx::MappedFile file;
+        if (!mapFile(file, path)) { return false; }
+        google::protobuf::io::CodedInputStream cis(reinterpret_cast<const google::protobuf::uint8*>(file.data()), static_cast<int>(file.size()));
+        return obj.ParseFromCodedStream(&cis);
+    }
+
     std::ifstream ifs(path);
     if (!ifs.is_open()) { return false; }
     std::ostringstream oss;
@@ -52,12 +80,70 @@ static bool load(const std::string &path, T &obj) {
 
 template<typename T>
 static bool save(const std::string &path, const T &obj) {
+    if (isBinaryPath(path)) {
+        std::ofstream ofs(path, std::ios::binary);
+        return ofs.is_open() && obj.SerializeToOstream(&ofs);
+    }
+
     std::ofstream ofs(path);
     if (!ofs.is_open()) { return false; }
     ofs << protobufToJson(obj);
     return true;
 }
 
+template<typename Header, typename Body>
+static bool load(const std::string &path, Header &header, Body &body) {
+    if (isBinaryPath(path)) {
+        szx::MappedFile file;
+        if (!mapFile(file, path)) { return false; }
+        google::protobuf::io::CodedInputStream cis(reinterpret_cast<const google::protobuf::uint8*>(file.data()), static_cast<int>(file.size()));
+        return google::protobuf::util::ParseDelimitedFromCodedStream(&header, &cis, nullptr)
+            && google::protobuf::util::ParseDelimitedFromCodedStream(&body, &cis, nullptr);
+    }
+
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) { return false; }
+    std::string line;
+    std::getline(ifs, line);
+    jsonToProtobuf(line, header);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    jsonToProtobuf(oss.str(), body);
+    return true;
+}
+
+template<typename Header, typename Body>
+static bool save(const std::string &path, const Header &header, const Body &body, bool binary) {
+    // the stream is closed before returning, so that a failure in flushing the last buffer is reported too.
+    if (binary) {
+        std::ofstream ofs(path, std::ios::binary);
+        if (!ofs.is_open()) { return false; }
+        bool isSerialized = google::protobuf::util::SerializeDelimitedToOstream(header, &ofs)
+            && google::protobuf::util::SerializeDelimitedToOstream(body, &ofs);
+        ofs.close();
+        return isSerialized && !ofs.fail();
+    }
+
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) { return false; }
+    ofs << protobufToJson(header, false) << std::endl << protobufToJson(body);
+    ofs.close();
+    return !ofs.fail();
+}
+
+template<typename Header, typename Body>
+static bool save(const std::string &path, const Header &header, const Body &body) {
+    return save(path, header, body, isBinaryPath(path));
+}
+
+// write to a temporary file and then replace the file at `path` with it,
+// so that a reader or a crash never sees a partially written file.
+template<typename Header, typename Body>
+static bool replace(const std::string &path, const Header &header, const Body &body) {
+    std::string tmpPath(path + ".tmp");
+    return save(tmpPath, header, body, isBinaryPath(path)) && szx::System::replaceFile(tmpPath, path);
+}
+
 }
 
 
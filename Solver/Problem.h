@@ -25,14 +25,14 @@ class Problem {
     #pragma region Type
 public:
     struct Input : public pb::InventoryRouting::Input {
+        // the format is chosen by the extension of `path`.
         bool load(const String &path) { return pb::load(path, *this); }
     };
 
     struct Output : public pb::InventoryRouting::Output {
+        // the format is chosen by the extension of `path`.
+        // the file is replaced atomically since it may already hold an anytime solution.
         bool save(const String &path, pb::Submission &submission) const {
-            std::ofstream ofs(path);
-            if (!ofs.is_open()) { return false; }
-
             // TODO[0]: fill the submission information.
             submission.set_author("szx");
             submission.set_algorithm("mp");
@@ -43,8 +43,7 @@ public:
             submission.set_os("Windows 10");
             submission.set_problem("InventoryRouting");
 
-            ofs << protobufToJson(submission, false) << std::endl << protobufToJson(*this);
-            return true;
+            return pb::replace(path, submission, *this);
         }
 
         Price totalCost = 0;
@@ -0,0 +1,185 @@
+////////////////////////////////
+/// usage : 1.	count the calls and the elapsed time of the hot spots for each worker.
+///
+/// note  : 1.	a probe is compiled to nothing if its switch in LogSwitch::Prof is off or SZX_DEBUG is off.
+///         2.	the probes in a thread are dropped until the thread is bound to a worker.
+////////////////////////////////
+
+#ifndef SMART_SZX_INVENTORY_ROUTING_PROFILER_H
+#define SMART_SZX_INVENTORY_ROUTING_PROFILER_H
+
+
+#include "Config.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "Common.h"
+#include "Utility.h"
+
+
+namespace szx {
+
+class Profiler {
+public:
+    enum Probe { CallModel, ModelCacheLookup, CallLkh, BuildMixNeigh, Disturb, MipSolution, MipProgress, ProbeNum };
+
+    using Clock = std::chrono::steady_clock;
+
+
+    static String probeName(Probe probe) {
+        static const String names[ProbeNum] = {
+            "callModel", "modelCache", "callLKH", "buildMixNeigh", "disturb", "mipSolution", "mipProgress"
+        };
+        return names[probe];
+    }
+
+    struct Counter {
+        Counter() : callNum(0), nanosecond(0) {}
+
+        void add(long long duration) {
+            callNum.fetch_add(1, std::memory_order_relaxed);
+            nanosecond.fetch_add(duration, std::memory_order_relaxed);
+        }
+
+        std::atomic<long long> callNum;
+        std::atomic<long long> nanosecond;
+    };
+
+    struct Worker {
+        Counter counters[ProbeNum];
+    };
+
+    enum CacheStat { ModelCacheStat, TspCacheStat, CacheStatNum };
+
+    static String cacheName(CacheStat cache) {
+        static const String names[CacheStatNum] = { "modelCache", "tspCache" };
+        return names[cache];
+    }
+
+
+    // add the elapsed time of the enclosing scope to the probe of the worker bound to the current thread.
+    template<int Level, bool Enabled = (SZX_DEBUG && (Level == Log::Level::On))>
+    class ScopedTimer {
+    public:
+        ScopedTimer(Probe probe) : worker(boundWorker()), counterIndex(probe), start(Clock::now()) {}
+        ~ScopedTimer() {
+            if (!worker) { return; }
+            long long duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            worker->counters[counterIndex].add(duration);
+        }
+
+    protected:
+        Worker *worker;
+        Probe counterIndex;
+        Clock::time_point start;
+    };
+    template<int Level>
+    class ScopedTimer<Level, false> {
+    public:
+        ScopedTimer(Probe) {}
+    };
+
+    // count the probes in the current thread for the worker until the binding is destructed.
+    class Binding {
+    public:
+        Binding(Worker *worker) : prevWorker(boundWorker()) { boundWorker() = worker; }
+        ~Binding() { boundWorker() = prevWorker; }
+
+    protected:
+        Worker *prevWorker;
+    };
+
+
+    static Worker*& boundWorker() {
+        static thread_local Worker *worker = nullptr;
+        return worker;
+    }
+
+
+    void init(int workerNum) { workers = Arr<Worker>(workerNum); }
+
+    Worker* worker(int workerId) { return &workers[workerId]; }
+
+    void addCacheStat(CacheStat cache, long long hitNum, long long missNum) {
+        cacheHitNums[cache] += hitNum;
+        cacheMissNums[cache] += missNum;
+    }
+    double hitRate(CacheStat cache) const {
+        long long lookupNum = cacheHitNums[cache] + cacheMissNums[cache];
+        return (lookupNum > 0) ? (static_cast<double>(cacheHitNums[cache]) / lookupNum) : 0;
+    }
+
+    long long callNum(Probe probe) const {
+        long long num = 0;
+        for (auto w = workers.begin(); w != workers.end(); ++w) { num += w->counters[probe].callNum; }
+        return num;
+    }
+    double seconds(Probe probe) const {
+        long long ns = 0;
+        for (auto w = workers.begin(); w != workers.end(); ++w) { ns += w->counters[probe].nanosecond; }
+        return ns / 1e9;
+    }
+
+    // print the calls, total and mean time of each probe for each worker and all workers.
+    void print(std::ostream &os) const {
+        os << std::left << std::setw(16) << "probe" << std::setw(8) << "worker"
+            << std::right << std::setw(12) << "calls" << std::setw(12) << "total(s)" << std::setw(12) << "mean(ms)" << std::endl;
+        for (int p = 0; p < ProbeNum; ++p) {
+            Probe probe = static_cast<Probe>(p);
+            if (callNum(probe) <= 0) { continue; }
+            int workerId = 0;
+            for (auto w = workers.begin(); w != workers.end(); ++w, ++workerId) {
+                if (workers.size() <= 1) { break; }
+                printRow(os, probe, std::to_string(workerId), w->counters[p].callNum, w->counters[p].nanosecond / 1e9);
+            }
+            printRow(os, probe, "all", callNum(probe), seconds(probe));
+        }
+        for (int c = 0; c < CacheStatNum; ++c) {
+            CacheStat cache = static_cast<CacheStat>(c);
+            os << cacheName(cache) << " hit rate=" << hitRate(cache)
+                << " (" << cacheHitNums[c] << "/" << (cacheHitNums[c] + cacheMissNums[c]) << ")" << std::endl;
+        }
+    }
+
+    // columns for the log file.
+    static String briefHeader() {
+        std::ostringstream oss;
+        for (int p = 0; p < ProbeNum; ++p) {
+            String name(probeName(static_cast<Probe>(p)));
+            oss << (p ? "," : "") << name << "Calls," << name << "Time";
+        }
+        for (int c = 0; c < CacheStatNum; ++c) { oss << "," << cacheName(static_cast<CacheStat>(c)) << "HitRate"; }
+        return oss.str();
+    }
+    String toBriefStr() const {
+        std::ostringstream oss;
+        for (int p = 0; p < ProbeNum; ++p) {
+            Probe probe = static_cast<Probe>(p);
+            oss << (p ? "," : "") << callNum(probe) << "," << seconds(probe);
+        }
+        for (int c = 0; c < CacheStatNum; ++c) { oss << "," << hitRate(static_cast<CacheStat>(c)); }
+        return oss.str();
+    }
+
+protected:
+    static void printRow(std::ostream &os, Probe probe, const String &worker, long long calls, double totalSecond) {
+        os << std::left << std::setw(16) << probeName(probe) << std::setw(8) << worker
+            << std::right << std::setw(12) << calls << std::setw(12) << std::fixed << std::setprecision(3) << totalSecond
+            << std::setw(12) << ((calls > 0) ? (1000 * totalSecond / calls) : 0) << std::defaultfloat << std::endl;
+    }
+
+
+    Arr<Worker> workers;
+    std::atomic<long long> cacheHitNums[CacheStatNum] = {};
+    std::atomic<long long> cacheMissNums[CacheStatNum] = {};
+};
+
+}
+
+
+#endif // SMART_SZX_INVENTORY_ROUTING_PROFILER_H
@@ -0,0 +1,126 @@
+#include "SolutionChecker.h"
+
+#include <cmath>
+
+
+using namespace std;
+
+
+namespace szx {
+
+const char* SolutionChecker::errorName(Error error) {
+    switch (error) {
+    case NoError: return "NoError";
+    case FormatError: return "FormatError";
+    case MultipleVisitsError: return "MultipleVisitsError";
+    case UnmatchedLoadDeliveryError: return "UnmatchedLoadDeliveryError";
+    case ExceedCapacityError: return "ExceedCapacityError";
+    case RunOutOfStockError: return "RunOutOfStockError";
+    default: return "UnknownError";
+    }
+}
+
+bool SolutionChecker::check(Report &report, const Input &input, const Output &output) {
+    report.clear();
+    if (!checkFormat(report, input, output)) { return false; }
+
+    int nodeNum = input.nodes_size();
+    const auto &periodRoutes(output.periodroutes());
+    const auto &nodes(input.nodes());
+
+    // check multiple visits.
+    int p = 0;
+    for (auto pr = periodRoutes.begin(); pr != periodRoutes.end(); ++pr, ++p) {
+        visitedTimes.assign(nodeNum, 0);
+        for (auto vr = pr->vehicleroutes().begin(); vr != pr->vehicleroutes().end(); ++vr) {
+            for (auto dl = vr->deliveries().begin(); dl != vr->deliveries().end(); ++dl) {
+                ++visitedTimes[dl->node()];
+            }
+        }
+        for (int i = input.depotnum(); i < nodeNum; ++i) {
+            if (visitedTimes[i] <= 1) { continue; }
+            addViolation(report, MultipleVisitsError, p, i, visitedTimes[i]);
+        }
+    }
+
+    // check load-deliver equality.
+    p = 0;
+    for (auto pr = periodRoutes.begin(); pr != periodRoutes.end(); ++pr, ++p) {
+        for (auto vr = pr->vehicleroutes().begin(); vr != pr->vehicleroutes().end(); ++vr) {
+            int totalQuantity = 0;
+            for (auto dl = vr->deliveries().begin(); dl != vr->deliveries().end(); ++dl) {
+                totalQuantity += dl->quantity();
+            }
+            if (totalQuantity == 0) { continue; }
+            addViolation(report, UnmatchedLoadDeliveryError, p, -1, totalQuantity);
+        }
+    }
+
+    // check rest quantity and holding cost.
+    restQuantity.resize(nodeNum);
+    int n = 0;
+    for (auto i = nodes.begin(); i != nodes.end(); ++i, ++n) {
+        restQuantity[n] = i->initquantity();
+        report.holdingCost += i->holdingcost() * i->initquantity();
+    }
+    p = 0;
+    for (auto pr = periodRoutes.begin(); pr != periodRoutes.end(); ++pr, ++p) {
+        for (auto vr = pr->vehicleroutes().begin(); vr != pr->vehicleroutes().end(); ++vr) {
+            for (auto dl = vr->deliveries().begin(); dl != vr->deliveries().end(); ++dl) {
+                restQuantity[dl->node()] += dl->quantity();
+            }
+        }
+        n = 0;
+        for (auto i = nodes.begin(); i != nodes.end(); ++i, ++n) {
+            if (restQuantity[n] > i->capacity()) { addViolation(report, ExceedCapacityError, p, n, restQuantity[n]); }
+            restQuantity[n] -= i->demands(p);
+            if (restQuantity[n] < i->minlevel()) { addViolation(report, RunOutOfStockError, p, n, restQuantity[n]); }
+            report.holdingCost += i->holdingcost() * restQuantity[n];
+        }
+    }
+
+    // check routing cost.
+    auto distance = [](const pb::Node &i, const pb::Node &j) {
+        return round(hypot(i.x() - j.x(), i.y() - j.y()));
+    };
+    for (auto pr = periodRoutes.begin(); pr != periodRoutes.end(); ++pr) {
+        for (auto vr = pr->vehicleroutes().begin(); vr != pr->vehicleroutes().end(); ++vr) {
+            if (vr->deliveries_size() <= 1) { continue; }
+            int prevNode = 0;
+            for (auto dl = vr->deliveries().begin(); dl != vr->deliveries().end(); ++dl) {
+                report.routingCost += distance(nodes.Get(prevNode), nodes.Get(dl->node()));
+                prevNode = dl->node();
+            }
+        }
+    }
+
+    return report.feasible();
+}
+
+bool SolutionChecker::checkFormat(Report &report, const Input &input, const Output &output) const {
+    int nodeNum = input.nodes_size();
+    int periodNum = input.periodnum();
+    if (output.periodroutes_size() > periodNum) { addViolation(report, FormatError, output.periodroutes_size(), -1, periodNum); }
+    for (int n = 0; n < nodeNum; ++n) {
+        if (input.nodes(n).demands_size() < output.periodroutes_size()) { addViolation(report, FormatError, -1, n, input.nodes(n).demands_size()); }
+    }
+
+    int p = 0;
+    for (auto pr = output.periodroutes().begin(); pr != output.periodroutes().end(); ++pr, ++p) {
+        if (pr->vehicleroutes_size() > input.vehicles_size()) { addViolation(report, FormatError, p, -1, pr->vehicleroutes_size()); }
+        for (auto vr = pr->vehicleroutes().begin(); vr != pr->vehicleroutes().end(); ++vr) {
+            for (auto dl = vr->deliveries().begin(); dl != vr->deliveries().end(); ++dl) {
+                if ((dl->node() < 0) || (dl->node() >= nodeNum)) { addViolation(report, FormatError, p, dl->node(), dl->quantity()); }
+            }
+        }
+    }
+    return report.feasible();
+}
+
+void SolutionChecker::addViolation(Report &report, Error error, int period, int node, int value) {
+    report.errors |= error;
+    if (report.violations.size() >= MaxViolationNum) { return; }
+    report.violations.push_back({ error, period, node, value });
+}
+
+}
@@ -0,0 +1,80 @@
+////////////////////////////////
+/// usage : 1.	check the feasibility and the objective of an inventory routing solution in memory.
+///
+/// note  : 1.	it only depends on the protocol, so that the solver, the simulator and the checker share the same rules.
+///         2.	the buffers are reused among the checks, so a checker should not be shared by concurrent threads.
+////////////////////////////////
+
+#ifndef SMART_SZX_INVENTORY_ROUTING_SOLUTION_CHECKER_H
+#define SMART_SZX_INVENTORY_ROUTING_SOLUTION_CHECKER_H
+
+
+#include <vector>
+
+#include "InventoryRouting.pb.h"
+
+
+namespace szx {
+
+class SolutionChecker {
+public:
+    using Input = pb::InventoryRouting::Input;
+    using Output = pb::InventoryRouting::Output;
+
+    // the flags can be combined by bitwise or.
+    enum Error {
+        NoError = 0x0,
+        FormatError = 0x1,
+        MultipleVisitsError = 0x2,
+        UnmatchedLoadDeliveryError = 0x4,
+        ExceedCapacityError = 0x8,
+        RunOutOfStockError = 0x10
+    };
+
+    struct Violation {
+        Error error;
+        int period;
+        int node; // -1 if it is not about a single node.
+        int value; // the visit times, the unbalanced quantity or the inventory level.
+    };
+
+    struct Report {
+        void clear() {
+            errors = NoError;
+            routingCost = 0;
+            holdingCost = 0;
+            violations.clear();
+        }
+
+        bool feasible() const { return (errors == NoError); }
+        double obj() const { return routingCost + holdingCost; }
+
+        int errors = NoError;
+        double routingCost = 0;
+        double holdingCost = 0;
+        std::vector<Violation> violations; // at most `MaxViolationNum` ones in the order of detection.
+    };
+
+
+    static constexpr int MaxViolationNum = 64;
+
+
+    static const char* errorName(Error error);
+
+
+    // return true if the solution is feasible.
+    bool check(Report &report, const Input &input, const Output &output);
+
+protected:
+    bool checkFormat(Report &report, const Input &input, const Output &output) const;
+    static void addViolation(Report &report, Error error, int period, int node, int value);
+
+
+    std::vector<int> visitedTimes;
+    std::vector<int> restQuantity;
+};
+
+}
+
+
+#endif // SMART_SZX_INVENTORY_ROUTING_SOLUTION_CHECKER_H
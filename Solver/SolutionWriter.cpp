@@ -0,0 +1,63 @@
+#include "SolutionWriter.h"
+
+
+using namespace std;
+
+
+namespace szx {
+
+void SolutionWriter::start(const String &slnPath, int minIntervalInMillisecond) {
+    stop();
+    path = slnPath;
+    minInterval = chrono::milliseconds(minIntervalInMillisecond);
+    lastWriteTime = Clock::now() - minInterval;
+    bestCost = Problem::MaxCost;
+    hasPending = false;
+    isStopped = false;
+    writer = thread([this]() { writeLoop(); });
+}
+
+void SolutionWriter::stop() {
+    {
+        lock_guard<mutex> lock(pendingMutex);
+        isStopped = true;
+    }
+    cond.notify_all();
+    if (writer.joinable()) { writer.join(); }
+}
+
+bool SolutionWriter::submit(pb::Submission &submission, Problem::Output &output) {
+    {
+        lock_guard<mutex> lock(pendingMutex);
+        if (isStopped || !(output.totalCost < bestCost)) { return false; }
+        bestCost = output.totalCost;
+        pendingSubmission.Swap(&submission);
+        pendingOutput.Swap(&output);
+        pendingOutput.totalCost = output.totalCost;
+        hasPending = true;
+    }
+    cond.notify_all();
+    return true;
+}
+
+void SolutionWriter::writeLoop() {
+    pb::Submission submission;
+    Problem::Output output;
+    unique_lock<mutex> lock(pendingMutex);
+    for (;;) {
+        cond.wait(lock, [this]() { return hasPending || isStopped; });
+        if (!hasPending) { break; }
+        // the solutions submitted during the wait are merged into the last one.
+        cond.wait_until(lock, lastWriteTime + minInterval, [this]() { return isStopped; });
+        submission.Swap(&pendingSubmission);
+        output.Swap(&pendingOutput);
+        hasPending = false;
+
+        lock.unlock();
+        output.save(path, submission);
+        lock.lock();
+        lastWriteTime = Clock::now();
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+////////////////////////////////
+/// usage : 1.	keep the best solution found so far on disk while the search goes on.
+///
+/// note  : 1.	the solutions are serialized and written by a background thread, so the search thread only hands them over.
+///         2.	a submitted solution replaces the pending one if it is better, and at most one file is written per interval.
+///         3.	the file is written to a temporary path and renamed, so it always holds a complete solution.
+////////////////////////////////
+
+#ifndef SMART_SZX_INVENTORY_ROUTING_SOLUTION_WRITER_H
+#define SMART_SZX_INVENTORY_ROUTING_SOLUTION_WRITER_H
+
+
+#include "Config.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Common.h"
+#include "Problem.h"
+
+
+namespace szx {
+
+class SolutionWriter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+
+    static constexpr int DefaultMinIntervalInMillisecond = 1000;
+
+
+    SolutionWriter() : minInterval(DefaultMinIntervalInMillisecond), bestCost(Problem::MaxCost), isStopped(true), hasPending(false) {}
+    SolutionWriter(const SolutionWriter&) = delete;
+    SolutionWriter& operator=(const SolutionWriter&) = delete;
+    ~SolutionWriter() { stop(); }
+
+    // start writing the submitted solutions to `path`.
+    void start(const String &path, int minIntervalInMillisecond = DefaultMinIntervalInMillisecond);
+    // write the pending solution and wait for the background thread to exit.
+    void stop();
+
+    // return true if a solution with `cost` would be accepted, so that the caller can skip building it.
+    bool isBetter(Price cost) const {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        return !isStopped && (cost < bestCost);
+    }
+    // return true if the next submission would be written without waiting for the interval.
+    bool isDue() const {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        return !isStopped && (Clock::now() - lastWriteTime >= minInterval);
+    }
+
+    // return false if the solution is dropped since a better one has been submitted.
+    bool submit(pb::Submission &submission, Problem::Output &output);
+
+protected:
+    void writeLoop();
+
+
+    String path;
+    std::chrono::milliseconds minInterval;
+    std::thread writer;
+
+    mutable std::mutex pendingMutex; // guard the fields below.
+    std::condition_variable cond;
+    Price bestCost; // the cost of the last submitted solution.
+    Clock::time_point lastWriteTime;
+    bool isStopped;
+    bool hasPending;
+    pb::Submission pendingSubmission;
+    Problem::Output pendingOutput;
+};
+
+}
+
+
+#endif // SMART_SZX_INVENTORY_ROUTING_SOLUTION_WRITER_H
@@ -8,6 +8,8 @@
 #include <thread>
 #include <mutex>
 #include <cmath>
+#include <csignal>
+#include <limits>
 
 #include "CsvReader.h"
 #include "MpSolver.h"
@@ -16,6 +18,8 @@ using namespace std;
 
 namespace szx {
 
+	atomic<bool> Solver::isTerminationRequested(false);
+
 #pragma region Solver::Cli
 	int Solver::Cli::run(int argc, char * argv[]) {
 		Log(LogSwitch::Szx::Cli) << "parse command line arguments." << endl;
@@ -30,7 +34,8 @@ namespace szx {
 			{ RunIdOption(), nullptr },
 			{ EnvironmentPathOption(), nullptr },
 			{ ConfigPathOption(), nullptr },
-			{ LogPathOption(), nullptr }
+			{ LogPathOption(), nullptr },
+			{ ResumePathOption(), nullptr }
 			});
 
 		for (int i = 1; i < argc; ++i) { // skip executable name.
@@ -63,16 +68,16 @@ namespace szx {
 		Problem::Input input;
 		if (!input.load(env.instPath)) { return -1; }
 
+		// save a checkpoint and the best solution before being killed.
+		signal(SIGTERM, Solver::requestTermination);
+		signal(SIGINT, Solver::requestTermination);
+
 		Solver solver(input, env, cfg);
 		solver.solve();
 
 		pb::Submission submission;
-		submission.set_thread(to_string(env.jobNum));
-		submission.set_instance(env.friendlyInstName());
-		//submission.set_duration(to_string(solver.timer.elapsedSeconds()) + "s");
-		submission.set_duration(to_string(Timer::durationInSecond(solver.timer.getStartTime(), solver.bestSlnTime)) + "s");
-
-		submission.set_obj(solver.output.totalCost);
+		//solver.initSubmission(submission, solver.output.totalCost, solver.timer.elapsedSeconds());
+		solver.initSubmission(submission, solver.output.totalCost, Timer::durationInSecond(solver.timer.getStartTime(), solver.bestSlnTime));
 
 		solver.output.save(env.slnPath, submission);
 #if SZX_DEBUG
@@ -118,6 +123,9 @@ namespace szx {
 		str = optionMap.at(Cli::LogPathOption());
 		if (str != nullptr) { logPath = str; }
 
+		str = optionMap.at(Cli::ResumePathOption());
+		if (str != nullptr) { resumePath = str; }
+
 		calibrate();
 	}
 
@@ -146,12 +154,37 @@ namespace szx {
 
 #pragma region Solver::Configuration
 	void Solver::Configuration::load(const String &filePath) {
-		// EXTEND[szx][5]: load configuration from file.
-		// EXTEND[szx][8]: check file existence first.
+		// each row is a `key,value` pair. the options which are not given keep their default values.
+		ifstream ifs(filePath);
+		if (!ifs.is_open()) { return; }
+		CsvReader cr;
+		const List<CsvReader::Row> &rows(cr.scan(ifs));
+		ifs.close();
+		for (auto r = rows.begin(); r != rows.end(); ++r) {
+			if (r->size() < 2) { continue; }
+			String key(r->front());
+			if (key == "threadNumPerWorker") { threadNumPerWorker = atoi((*r)[1]); }
+			else if (key == "mipThreadNum") { mipThreadNum = atoi((*r)[1]); }
+			else if (key == "windowJobNum") { windowJobNum = atoi((*r)[1]); }
+			else if (key == "mipHint") { mipHint = (atoi((*r)[1]) != 0); }
+			else if (key == "elitePoolSize") { elitePoolSize = atoi((*r)[1]); }
+			else if (key == "modelCacheSize") { modelCacheSize = atoi((*r)[1]); }
+			else if (key == "lkhInterval") { lkhInterval = atoi((*r)[1]); }
+			else if (key == "checkpointInterval") { checkpointInterval = atoi((*r)[1]); }
+		}
 	}
 
 	void Solver::Configuration::save(const String &filePath) const {
-		// EXTEND[szx][5]: save configuration to file.
+		ofstream ofs(filePath);
+		if (!ofs.is_open()) { return; }
+		ofs << "threadNumPerWorker," << threadNumPerWorker << endl
+			<< "mipThreadNum," << mipThreadNum << endl
+			<< "windowJobNum," << windowJobNum << endl
+			<< "mipHint," << mipHint << endl
+			<< "elitePoolSize," << elitePoolSize << endl
+			<< "modelCacheSize," << modelCacheSize << endl
+			<< "lkhInterval," << lkhInterval << endl
+			<< "checkpointInterval," << checkpointInterval << endl;
 	}
 #pragma endregion Solver::Configuration
 
@@ -159,11 +192,26 @@ namespace szx {
 	bool Solver::solve() {
 		init();
 
+		// the checkpoint is loaded before the workers start, and the time spent before it is taken from the time limit.
+		isResumed = !env.resumePath.empty() && loadCheckpoint(env.resumePath, resumedScheduler);
+		if (isResumed) {
+			double spentSecond = 0;
+			for (int p = 0; p < Scheduler::PhaseNum; ++p) { spentSecond += resumedScheduler.spentSeconds[p]; }
+			Timer::Millisecond restTime = Timer::Millisecond(env.msTimeout) - Timer::toMillisecond(spentSecond);
+			timer = Timer((max)(restTime, Timer::Millisecond(0)), timer.getStartTime());
+			Log(LogSwitch::Szx::Framework) << "resume " << env.resumePath << " which has spent " << spentSecond << "s." << endl;
+		}
+
 		int workerNum = (max)(1, env.jobNum / cfg.threadNumPerWorker);
 		cfg.threadNumPerWorker = env.jobNum / workerNum;
 		List<Solution> solutions(workerNum, Solution(this));
 		List<bool> success(workerNum);
 
+		profiler.init(workerNum);
+		improvements.clear();
+		bestSlnTime = timer.getEndTime();// ҵŽʱ
+		AsyncLog::instance().restart();
+		if (!env.slnPath.empty()) { slnWriter.start(env.slnPath); }
 		Log(LogSwitch::Szx::Framework) << "launch " << workerNum << " workers." << endl;
 		List<thread> threadList;
 		threadList.reserve(workerNum);
@@ -173,6 +221,15 @@ namespace szx {
 			threadList.emplace_back([&, i]() { success[i] = optimize(solutions[i], i); });
 		}
 		for (int i = 0; i < workerNum; ++i) { threadList.at(i).join(); }
+		AsyncLog::instance().flush();
+		slnWriter.stop(); // the final solution is saved by the caller.
+
+		profiler.addCacheStat(Profiler::ModelCacheStat, aux.modelCache.getHitNum(), aux.modelCache.getMissNum());
+		if (Log::isTurnedOn(LogSwitch::Prof::Summary)) {
+			ostringstream oss;
+			profiler.print(oss);
+			Log(LogSwitch::Prof::Summary) << "profile:" << endl << oss.str();
+		}
 
 		Log(LogSwitch::Szx::Framework) << "collect best result among all workers." << endl;
 		int bestIndex = -1;
@@ -187,10 +244,35 @@ namespace szx {
 
 		env.rid = to_string(bestIndex);
 		if (bestIndex < 0) { return false; }
-		output = solutions[bestIndex];
+		solutions[bestIndex].toOutput(output);
 		return true;
 	}
 
+	void Solver::initSubmission(pb::Submission &submission, Price obj, double durationInSecond) const {
+		submission.set_thread(to_string(env.jobNum));
+		submission.set_instance(env.friendlyInstName());
+		submission.set_duration(to_string(durationInSecond) + "s");
+		submission.set_obj(obj);
+	}
+
+	void Solver::Solution::toOutput(Problem::Output &output) const {
+		output.Clear();
+		output.totalCost = totalCost;
+		for (ID p = 0; p < periodNum; ++p) {
+			auto &periodRoute(*output.add_periodroutes());
+			for (ID v = 0; v < vehicleNum; ++v) {
+				auto &route(*periodRoute.add_vehicleroutes());
+				const ID *n = routeNodes(p, v);
+				const Quantity *q = routeQuantities(p, v);
+				for (ID i = 0; i < routeLen(p, v); ++i) {
+					auto &d(*route.add_deliveries());
+					d.set_node(n[i]);
+					d.set_quantity(q[i]);
+				}
+			}
+		}
+	}
+
 	void Solver::record() const {
 #if SZX_DEBUG
 		int generation = 0;
@@ -217,7 +299,7 @@ namespace szx {
 
 		double checkerObj = -1;
 		bool feasible = check(checkerObj);
-		double objDiff = round(output.totalCost * Problem::CheckerObjScale - checkerObj) / Problem::CheckerObjScale;
+		double objDiff = round((output.totalCost - checkerObj) * Problem::CheckerObjScale) / Problem::CheckerObjScale;
 
 		// record basic information.
 		log << env.friendlyLocalTime() << ","
@@ -233,7 +315,11 @@ namespace szx {
 			<< mu.physicalMemory << "," << mu.virtualMemory << ","
 			<< env.randSeed << ","
 			<< cfg.toBriefStr() << ","
-			<< generation << "," << iteration;
+			<< generation << "," << iteration << ",";
+		for (auto i = improvements.begin(); i != improvements.end(); ++i) { // anytime profile.
+			log << i->time << ":" << i->cost << ":" << Improvement::sourceName(i->source) << ";";
+		}
+		log << "," << profiler.toBriefStr() << ",";
 
 		// record solution vector.
 		// EXTEND[szx][2]: save solution in log.
@@ -246,7 +332,8 @@ namespace szx {
 		ofstream logFile(env.logPath, ios::app);
 		logFile.seekp(0, ios::end);
 		if (logFile.tellp() <= 0) {
-			logFile << "Time,ID,Instance,Feasible,ObjMatch,Cost,MinCost,RefCost,Duration,RefDuration,PhysMem,VirtMem,RandSeed,Config,Generation,Iteration,Solution" << endl;
+			logFile << "Time,ID,Instance,Feasible,ObjMatch,Cost,MinCost,RefCost,Duration,RefDuration,PhysMem,VirtMem,RandSeed,Config,Generation,Iteration,Trajectory,"
+				<< Profiler::briefHeader() << ",Solution" << endl;
 		}
 		logFile << log.str();
 		logFile.close();
@@ -255,28 +342,15 @@ namespace szx {
 
 	bool Solver::check(double &checkerObj) const {
 #if SZX_DEBUG
-		enum CheckerFlag {
-			IoError = 0x0,
-			FormatError = 0x1,
-			MultipleVisitsError = 0x2,
-			UnmatchedLoadDeliveryError = 0x4,
-			ExceedCapacityError = 0x8,
-			RunOutOfStockError = 0x10
-		};
-
-		int errorCode = System::exec("Checker.exe " + env.instPath + " " + env.solutionPathWithTime());
-		if (errorCode > 0) {
-			checkerObj = errorCode;
-			return true;
+		SolutionChecker checker;
+		SolutionChecker::Report report;
+		bool feasible = checker.check(report, input, output);
+		checkerObj = report.obj();
+		for (auto v = report.violations.begin(); v != report.violations.end(); ++v) {
+			Log(LogSwitch::Checker) << SolutionChecker::errorName(v->error) << " at period " << v->period
+				<< " node " << v->node << " value " << v->value << "." << endl;
 		}
-		errorCode = ~errorCode;
-		if (errorCode == CheckerFlag::IoError) { Log(LogSwitch::Checker) << "IoError." << endl; }
-		if (errorCode & CheckerFlag::FormatError) { Log(LogSwitch::Checker) << "FormatError." << endl; }
-		if (errorCode & CheckerFlag::MultipleVisitsError) { Log(LogSwitch::Checker) << "MultipleVisitsError." << endl; }
-		if (errorCode & CheckerFlag::UnmatchedLoadDeliveryError) { Log(LogSwitch::Checker) << "UnmatchedLoadDeliveryError." << endl; }
-		if (errorCode & CheckerFlag::ExceedCapacityError) { Log(LogSwitch::Checker) << "ExceedCapacityError." << endl; }
-		if (errorCode & CheckerFlag::RunOutOfStockError) { Log(LogSwitch::Checker) << "RunOutOfStockError." << endl; }
-		return false;
+		return feasible;
 #else
 		checkerObj = 0;
 		return true;
@@ -284,30 +358,68 @@ namespace szx {
 	}
 
 	void Solver::init() {
-		nodeNum = input.nodes_size(), periodNum = input.periodnum();
+		inst.init(input);
+		nodeNum = inst.nodeNum(), periodNum = inst.periodNum();
 		aux.routingCost.init(nodeNum, nodeNum);
 		aux.routingCost.reset();
 		aux.bestVisits.init(periodNum, nodeNum);
 		aux.curVisits.init(periodNum, nodeNum);
+		aux.modelCache.setCapacity((max)(cfg.modelCacheSize, 0));
+		aux.screenedNeighNum = 0;
+		aux.prunedNeighNum = 0;
+		fixVisits();
 		aux.curTours.init(periodNum);	//ǰ·ɼ
 		aux.tourPrices.init(periodNum);	//ÿ·ɶӦĳɱ
-		H1.resize(BitSize); H2.resize(BitSize); H3.resize(BitSize);
+		H1.init(BitSize); H2.init(BitSize); H3.init(BitSize);
 
-		ID n = 0;
-		for (auto i = input.nodes().begin(); i != input.nodes().end(); ++i, ++n) {
-			ID m = 0;
-			for (auto j = input.nodes().begin(); j != i; ++j, ++m) {
-				double value = round(hypot(i->x() - j->x(), i->y() - j->y()));
+		for (ID n = 0; n < nodeNum; ++n) {
+			for (ID m = 0; m < n; ++m) {
+				double value = round(hypot(inst.x(n) - inst.x(m), inst.y(n) - inst.y(m)));
 				aux.routingCost[n][m] = aux.routingCost[m][n] = value;
 			}
 		}
 
+		aux.tourRepair.init(aux.routingCost);
+		aux.staleTours.assign(periodNum, false);
+
 		aux.initHoldingCost = 0;
-		for (auto i = input.nodes().begin(); i != input.nodes().end(); ++i) {
-			aux.initHoldingCost += i->holdingcost() * i->initquantity();
+		for (ID n = 0; n < nodeNum; ++n) {
+			aux.initHoldingCost += inst.holdingCost(n) * inst.initQuantity(n);
 		}
 	}
 
+	void Solver::fixVisits() {
+		ID vehicleNum = inst.vehicleNum();
+		aux.forcedVisits.init(periodNum, nodeNum);
+		aux.forbiddenVisits.init(periodNum, nodeNum);
+
+		ID forcedNum = 0, forbiddenNum = 0;
+		for (ID n = inst.depotNum(); n < nodeNum; ++n) {
+			Quantity maxDelivery = 0; // all vehicles may deliver at the same period.
+			for (ID v = 0; v < vehicleNum; ++v) { maxDelivery += inst.deliveryCapacity(v, n); }
+			// minLevel and maxLevel are the least and most quantity of node n at the beginning of period p.
+			// minLevel does not depend on the deliveries, so it is taken from the cumulative demand directly.
+			Quantity maxLevel = inst.initQuantity(n);
+			for (ID p = 0; p < periodNum; ++p) {
+				Quantity minLevel = inst.initQuantity(n) - inst.cumDemand(p, n);
+				// run out of stock without a delivery at p even if it is filled up at every previous period.
+				if (maxLevel < inst.demand(p, n)) { aux.forcedVisits[p][n] = 1; ++forcedNum; }
+				// no room for the least delivery even if nothing is delivered at any previous period.
+				if (inst.capacity(n) - minLevel < 1) { aux.forbiddenVisits[p][n] = 1; ++forbiddenNum; }
+				maxLevel = min(inst.capacity(n), maxLevel + maxDelivery) - inst.demand(p, n);
+			}
+		}
+		Log(LogSwitch::Szx::Preprocess) << "fix " << forcedNum << " forced visits and " << forbiddenNum << " forbidden visits." << endl;
+	}
+
+	bool Solver::isVisitable(ID p, ID n, ID m) const {
+		return !aux.forbiddenVisits.at(p, n) && !aux.forbiddenVisits.at(p, m);
+	}
+
+	bool Solver::isMovable(ID apid, ID anid, ID dpid, ID dnid) const {
+		return !aux.forbiddenVisits.at(apid, anid) && !aux.forcedVisits.at(dpid, dnid);
+	}
+
 	//¼ӦvisitstourstourPrices
 	void Solver::initialSln(Solution &sln) {
 		aux.bestCost = sln.totalCost;
@@ -316,13 +428,14 @@ namespace szx {
 		for (ID p = 0; p < periodNum; ++p) {
 			aux.bestVisits[p][0] = 1;	//ֿһԽӰ
 			aux.curTours[p].clear();
-			for (ID v = 0; v < input.vehicles_size(); ++v) {
-				auto &delivs(*sln.mutable_periodroutes(p)->mutable_vehicleroutes(v)->mutable_deliveries());
-				if (!delivs.empty()) {
-					aux.curTours[p].push_back(delivs.rbegin()->node()); // ·мֿ
-					for (auto n = delivs.cbegin(); n != delivs.cend(); ++n) {
-						aux.bestVisits[p][n->node()] = 1;
-						aux.curTours[p].push_back(n->node());
+			for (ID v = 0; v < inst.vehicleNum(); ++v) {
+				ID len = sln.routeLen(p, v);
+				const ID *delivs = sln.routeNodes(p, v);
+				if (len > 0) {
+					aux.curTours[p].push_back(delivs[len - 1]); // ·мֿ
+					for (ID i = 0; i < len; ++i) {
+						aux.bestVisits[p][delivs[i]] = 1;
+						aux.curTours[p].push_back(delivs[i]);
 					}
 				}
 				else { aux.curTours[p] = { 0,0 }; }
@@ -333,50 +446,80 @@ namespace szx {
 		}
 	}
 
-	int Solver::buildMixNeigh(Arr2D<ID> &visits, Price minCost) {
+	int Solver::buildMixNeigh(VisitMatrix &visits, Price minCost) {
+		Profiler::ScopedTimer<LogSwitch::Prof::Neighborhood> probe(Profiler::BuildMixNeigh);
+		using Word = VisitMatrix::Word;
+
 		aux.mixNeigh.clear();
-		List<Actor> delNeigh, movNeigh, swpNeigh;
+		// only the cheapest maxSize actors of each type are evaluated by the model,
+		// so they are selected by bounded heaps during the enumeration.
+		unsigned maxSize = 2 * periodNum * static_cast<unsigned>(sqrt(nodeNum));
+		List<Actor> &delNeigh(aux.delNeigh), &movNeigh(aux.movNeigh), &swpNeigh(aux.swpNeigh);
+		delNeigh.clear();
+		movNeigh.clear();
+		swpNeigh.clear();
 
+		// the forced visits can not be removed and the forbidden visits can not be added.
+		Word allPeriods = visits.allPeriods();
 		for (ID n = 1; n < nodeNum; ++n) {
-			List<ID> P0, P1;
-			for (ID p = 0; p < periodNum; ++p) {
-				if (visits[p][n]) {
-					P1.push_back(p);
-					Actor act(DEL, delNodeTourCost(p, n), 0.0, -1, -1, p, n);
-					if (!isTabu(hashValue1, hashValue2, hashValue3, act)) { delNeigh.push_back(act); }
-				}
-				else { P0.push_back(p); }
-			}
-
-			for (ID p0 : P0) {
-				for (ID p1 : P1) {
-					Actor act(MOV, movNodeTourCost(p0, n, p1, n), 0.0, p0, n, p1, n);
+			Word P1 = visits.pattern(n) & ~aux.forcedVisits.pattern(n);
+			Word P0 = ~visits.pattern(n) & ~aux.forbiddenVisits.pattern(n) & allPeriods;
+			for (Word ps = P1; ps; ps &= (ps - 1)) {
+				ID p = VisitMatrix::lowestBit(ps);
+				Price tourCost = delNodeTourCost(p, n);
+				if (!isCheapEnough(delNeigh, tourCost, maxSize)) { continue; }
+				Actor act(DEL, tourCost, 0.0, -1, -1, p, n);
+				if (!isTabu(hashValue1, hashValue2, hashValue3, act)) { keepCheapest(delNeigh, act, maxSize); }
+			}
+
+			for (Word ps0 = P0; ps0; ps0 &= (ps0 - 1)) {
+				ID p0 = VisitMatrix::lowestBit(ps0);
+				for (Word ps1 = P1; ps1; ps1 &= (ps1 - 1)) {
+					ID p1 = VisitMatrix::lowestBit(ps1);
+					Price tourCost = movNodeTourCost(p0, n, p1, n);
+					if (!isCheapEnough(movNeigh, tourCost, maxSize)) { continue; }
+					Actor act(MOV, tourCost, 0.0, p0, n, p1, n);
 					if (isTabu(hashValue1, hashValue2, hashValue3, act)) { continue; }
-					movNeigh.push_back(act);
+					keepCheapest(movNeigh, act, maxSize);
 				}
 			}
 		}
 		for (ID n = 1; n < nodeNum; ++n) {
+			Word pn = visits.pattern(n);
 			for (ID m = n + 1; m < nodeNum; ++m) {
-				List<ID> tvn, tvm;
-				for (ID p = 0; p < periodNum; ++p) {
-					if (visits[p][n] && !visits[p][m]) { tvn.push_back(p); }
-					if (!visits[p][n] && visits[p][m]) { tvm.push_back(p); }
-				}
-				for (ID t1 : tvn) {
-					for (ID t2 : tvm) {
-						Actor act(SWP, swpNodeTourCost(t1, n, t2, m), 0.0, t1, n, t2, m);
+				Word pm = visits.pattern(m);
+				// periods only visited by n and periods only visited by m.
+				Word tvn = pn & ~pm & ~aux.forcedVisits.pattern(n) & ~aux.forbiddenVisits.pattern(m);
+				Word tvm = pm & ~pn & ~aux.forcedVisits.pattern(m) & ~aux.forbiddenVisits.pattern(n);
+				if (!tvn || !tvm) { continue; }
+				for (Word ps1 = tvn; ps1; ps1 &= (ps1 - 1)) {
+					ID t1 = VisitMatrix::lowestBit(ps1);
+					for (Word ps2 = tvm; ps2; ps2 &= (ps2 - 1)) {
+						ID t2 = VisitMatrix::lowestBit(ps2);
+						Price tourCost = swpNodeTourCost(t1, n, t2, m);
+						if (!isCheapEnough(swpNeigh, tourCost, maxSize)) { continue; }
+						Actor act(SWP, tourCost, 0.0, t1, n, t2, m);
 						if (isTabu(hashValue1, hashValue2, hashValue3, act)) { continue; }
-						swpNeigh.push_back(act);
+						keepCheapest(swpNeigh, act, maxSize);
 					}
 				}
 			}
 		}
 		
-		std::sort(delNeigh.begin(), delNeigh.end(), [](Actor &a1, Actor &a2) {return a1.totalCost < a2.totalCost; });
-		std::sort(movNeigh.begin(), movNeigh.end(), [](Actor &a1, Actor &a2) {return a1.totalCost < a2.totalCost; });
-		std::sort(swpNeigh.begin(), swpNeigh.end(), [](Actor &a1, Actor &a2) {return a1.totalCost < a2.totalCost; });
-		unsigned maxSize = 2 * periodNum * static_cast<unsigned>(sqrt(nodeNum));
+		std::sort_heap(delNeigh.begin(), delNeigh.end(), isCheaper);
+		std::sort_heap(movNeigh.begin(), movNeigh.end(), isCheaper);
+		std::sort_heap(swpNeigh.begin(), swpNeigh.end(), isCheaper);
+
+		// the duals of the current model bound the holding cost of each neighbor from below,
+		// so the exact evaluation can be skipped if even the bound cannot reach minCost.
+		Price baseCost = callModel(visits, &aux.visitDuals);
+		auto isHopeless = [&](const Actor &act) {
+			if (baseCost < 0) { return false; }
+			Price bound = act.totalCost + modelCostBound(act, baseCost);
+			if (Math::weakLess(bound, minCost)) { return false; }
+			++aux.prunedNeighNum;
+			return true;
+		};
 
 		/*
 			for (ID i = 0; i < maxSize && i < delNeigh.size(); ++i) {
@@ -445,6 +588,8 @@ namespace szx {
 		for (ID i = 0; i < maxSize && i < delNeigh.size(); ++i) {
 			auto &del(delNeigh[i]);
 			execTabu(hashValue1, hashValue2, hashValue3, del);
+			++aux.screenedNeighNum;
+			if (isHopeless(del)) { continue; }
 			visits[del.p2][del.n2] = 0;
 			if ((del.modelCost = callModel(visits)) >= 0) {
 				del.totalCost += del.modelCost;
@@ -462,6 +607,8 @@ namespace szx {
 		for (ID i = 0; i < maxSize && i < movNeigh.size(); ++i) {
 			auto &mov(movNeigh[i]);
 			execTabu(hashValue1, hashValue2, hashValue3, mov);
+			++aux.screenedNeighNum;
+			if (isHopeless(mov)) { continue; }
 			visits[mov.p1][mov.n1] = 1; visits[mov.p2][mov.n2] = 0;
 			if ((mov.modelCost = callModel(visits)) >= 0) {
 				mov.totalCost += mov.modelCost;
@@ -479,6 +626,8 @@ namespace szx {
 		for (ID i = 0; i < maxSize && i < swpNeigh.size(); ++i) {
 			auto &swp(swpNeigh[i]);
 			execTabu(hashValue1, hashValue2, hashValue3, swp);
+			++aux.screenedNeighNum;
+			if (isHopeless(swp)) { continue; }
 			visits[swp.p1][swp.n1] = visits[swp.p2][swp.n2] = 0;
 			visits[swp.p1][swp.n2] = visits[swp.p2][swp.n1] = 1;
 			if ((swp.modelCost = callModel(visits)) >= 0) {
@@ -498,15 +647,28 @@ namespace szx {
 		return aux.mixNeigh.size();
 	}
 
-	void Solver::disturb(Arr2D<ID> &visits) {
+	Price Solver::modelCostBound(const Actor &act, Price baseCost) const {
+		// the optimal value of the LP is convex in the right-hand side and the duals are its subgradient,
+		// i.e., v(b') >= v(b) + y * (b' - b) where b[p, n] changes by the capacity sum when a visit is added or removed.
+		const Arr2D<Price> &dual(aux.visitDuals);
+		switch (act.actype) {
+		case DEL: return baseCost - dual[act.p2][act.n2];
+		case MOV: return baseCost + dual[act.p1][act.n1] - dual[act.p2][act.n2];
+		case SWP: return baseCost - dual[act.p1][act.n1] - dual[act.p2][act.n2] + dual[act.p1][act.n2] + dual[act.p2][act.n1];
+		default: return baseCost;
+		}
+	}
+
+	void Solver::disturb(VisitMatrix &visits) {
+		Profiler::ScopedTimer<LogSwitch::Prof::Disturb> probe(Profiler::Disturb);
 		ID addNumber = 2 + rand.pick(2), delNumber = 1 + rand.pick(2), movNumber = 4 + rand.pick(3);
 		do {
 			List<ID> room, addOpts, delOpts;
 			// Ӳ
-			const auto &nodes(*input.mutable_nodes());
 			for (ID p = 0; p < periodNum; ++p) {
 				for (ID n = 1; n < nodeNum; ++n) {
-					if (!visits[p][n] && nodes[n].holdingcost() < nodes[0].holdingcost()) { room.push_back(p*nodeNum + n); }
+					if (aux.forbiddenVisits.at(p, n)) { continue; }
+					if (!visits[p][n] && inst.holdingCost(n) < inst.holdingCost(0)) { room.push_back(p*nodeNum + n); }
 				}
 			}
 			sampling(room, addOpts, addNumber);
@@ -517,8 +679,8 @@ namespace szx {
 			for (ID n = 1; n < nodeNum; ++n) {
 				for (ID p1 = 0; p1 < periodNum; ++p1) {
 					for (ID p2 = p1 + 1; p2 < periodNum; ++p2) {
-						if (visits[p1][n] && !visits[p2][n]) { movRoom.push_back({ p2*nodeNum + n,p1*nodeNum + n }); }
-						if (!visits[p1][n] && visits[p2][n]) { movRoom.push_back({ p1*nodeNum + n,p2*nodeNum + n }); }
+						if (visits[p1][n] && !visits[p2][n] && isMovable(p2, n, p1, n)) { movRoom.push_back({ p2*nodeNum + n,p1*nodeNum + n }); }
+						if (!visits[p1][n] && visits[p2][n] && isMovable(p1, n, p2, n)) { movRoom.push_back({ p1*nodeNum + n,p2*nodeNum + n }); }
 					}
 				}
 			}
@@ -547,7 +709,7 @@ namespace szx {
 			room.clear();
 			for (ID p = 0; p < periodNum; ++p) {
 				for (ID n = 1; n < nodeNum; ++n) {
-					if (visits[p][n]) { room.push_back(p*nodeNum + n); }
+					if (visits[p][n] && !aux.forcedVisits.at(p, n)) { room.push_back(p*nodeNum + n); }
 				}
 			}
 			for (ID delNum = 0; delNum < delNumber && room.size()>0;) {
@@ -561,25 +723,26 @@ namespace szx {
 				room.erase(room.begin() + pos);
 			}
 
-		} while (!timer.isTimeOut() && isTabu(visits));
+		} while (!isStopping() && isTabu(visits));
 
 		Price totalCost = callModel(visits) + callLKH(visits);
-		Log(LogSwitch::Szx::Search) << "After disturb, cost=" << totalCost << endl;
+		AsyncLog::write(LogSwitch::Szx::Search, AsyncLog::Disturb, "after", totalCost);
 
 		if (Math::strongLess(totalCost, aux.bestCost)) {
-			bestSlnTime = szx::Timer::Clock::now();
+			recordImprovement(totalCost, Improvement::Disturb);
 			aux.bestCost = totalCost;
 			aux.bestVisits = visits;
-			Log(LogSwitch::Szx::Opt) << "By disturb, opt=" << aux.bestCost << endl;
+			AsyncLog::write(LogSwitch::Szx::Opt, AsyncLog::Disturb, "opt", aux.bestCost);
 		}
 
 		mixTabuSearch(visits, totalCost);
 	}
 
-	bool Solver::mixTabuSearch(Arr2D<ID> &visits, Price modelCost) {
+	bool Solver::mixTabuSearch(VisitMatrix &visits, Price modelCost) {
 		execTabu(visits, true);	// ʼ⣬ʼȫ hashValue
 		bool isImproved = false; ID mixNeighSize = 0;
-		for (ID step = 0; !timer.isTimeOut() && step < alpha && (mixNeighSize = buildMixNeigh(visits)); ++step) {
+		ID repairNum = 0;
+		for (ID step = 0; !isStopping() && step < alpha && (mixNeighSize = buildMixNeigh(visits)); ++step) {
 			const auto &act(aux.mixNeigh[rand.pick(mixNeighSize)]);
 			if (act.actype == ActorType::SWP) {
 				visits[act.p1][act.n1] = visits[act.p2][act.n2] = 0;
@@ -590,22 +753,31 @@ namespace szx {
 				if (act.n2 > 0) visits[act.p2][act.n2] = 0;
 			}
 			// ȷ·ɣõȷܳɱ
-			modelCost = act.modelCost + callLKH(visits, act.p1, act.p2);
+			if (cfg.lkhInterval > 1) {
+				// the repaired tours are confirmed by LKH before being accepted as the best.
+				modelCost = act.modelCost + repairTours(visits, act.p1, act.p2);
+				if ((++repairNum % cfg.lkhInterval == 0) || Math::strongLess(modelCost, aux.bestCost)) {
+					modelCost = act.modelCost + reoptimizeTours(visits);
+				}
+			}
+			else {
+				modelCost = act.modelCost + callLKH(visits, act.p1, act.p2);
+			}
 			execTabu(act);	// ıȫ hashValue
 			if (Math::strongLess(modelCost, aux.bestCost)) {
-				bestSlnTime = szx::Timer::Clock::now();
+				recordImprovement(modelCost, Improvement::TabuSearch);
 				isImproved = true;
 				step = -1;
 				aux.bestCost = modelCost;
 				aux.bestVisits = visits;
-				Log(LogSwitch::Szx::Opt) << "By TS, opt=" << aux.bestCost << endl;
+				AsyncLog::write(LogSwitch::Szx::Opt, AsyncLog::TabuSearch, "opt", aux.bestCost);
 			}
 		}
-		Log(LogSwitch::Szx::Search) << "After TS, cost = " << modelCost << "\n" << endl;
+		AsyncLog::write(LogSwitch::Szx::Search, AsyncLog::TabuSearch, "after", modelCost);
 		return isImproved;
 	}
 
-	void Solver::mixFinalSearch() {
+	void Solver::mixFinalSearch(const Scheduler &scheduler) {
 		//// ʷŻߵǰŶ
 		//double gamma = 0.99;	// epsilon ˥ϵ
 		//for (int i = 0; !timer.isTimeOut(); ++i) {
@@ -616,46 +788,315 @@ namespace szx {
 		//	disturb(aux.curVisits);
 		//}
 
-		while (!timer.isTimeOut()) {
+		Solution bestSln;
+		bestSln.init(periodNum, inst.vehicleNum(), nodeNum);
+		while (!isStopping()) {
+			// the tours modified by getBestSln() are rebuilt by disturb() before they are used.
+			if (slnWriter.isDue() && slnWriter.isBetter(aux.bestCost) && getBestSln(bestSln, aux.bestVisits)) {
+				streamSln(bestSln);
+			}
+			checkpoint(scheduler, Scheduler::Local, false);
 			aux.curVisits = aux.bestVisits;
 			disturb(aux.curVisits);
 		}
 	}
 
 	void Solver::execSearch(Solution &sln) {
-		timer = Timer(3600s, timer.getStartTime());
-		bestSlnTime = timer.getEndTime();// ҵŽʱ
+		Scheduler scheduler;
+		lastCheckpointTime = Timer::Clock::now();
+
+		// the phases before `resumePhase` are done, either in this run or in the one which saved the checkpoint.
+		Scheduler::Phase resumePhase = Scheduler::Model;
+		if (isResumed) {
+			scheduler = resumedScheduler;
+			scheduler.phaseTimer = Timer(Timer::Millisecond(0)); // the time before the search is not counted in the phase.
+			resumePhase = scheduler.curPhase;
+			// getBestSln() rebuilds the tours for the best visits, so the restored tours of the current visits are put back after it.
+			Arr<List<ID>> curTours(aux.curTours);
+			Arr<Price> tourPrices(aux.tourPrices);
+			List<bool> staleTours(aux.staleTours);
+			getBestSln(sln, aux.bestVisits);
+			swap(aux.curTours, curTours);
+			swap(aux.tourPrices, tourPrices);
+			swap(aux.staleTours, staleTours);
+			recordImprovement(sln.totalCost, Improvement::Checkpoint);
+			Log(LogSwitch::Szx::Search) << "resume at phase " << Scheduler::phaseName(resumePhase) << " with cost=" << sln.totalCost << endl;
+		}
+		bool isLocalResumed = isResumed && (resumePhase == Scheduler::Local);
+
+		if (resumePhase <= Scheduler::Model) {
+			scheduler.enter(Scheduler::Model, timer.restSeconds());
+			iteratedModel(sln, scheduler.budget);	// ɳģ
+			// the gain of the model phase is counted from its first feasible solution.
+			Price firstCost = Problem::MaxCost;
+			{
+				lock_guard<mutex> improvementLock(improvementMutex);
+				if (!improvements.empty()) { firstCost = improvements.front().cost; }
+			}
+			if (firstCost < Problem::MaxCost) { scheduler.record(firstCost, aux.bestCost); }
+			Log(LogSwitch::Szx::Search) << "phase " << Scheduler::phaseName(Scheduler::Model) << " takes "
+				<< scheduler.elapsedSeconds() << "/" << scheduler.budget << "s, gain=" << scheduler.gains[Scheduler::Model] << endl;
+			// the model phase is redone on resume if it has not found any solution.
+			if (sln.totalCost < Problem::MaxCost) {
+				resumePhase = Scheduler::Window3;
+				checkpoint(scheduler, resumePhase);
+			}
+		}
+
+		// re-optimize the sliding windows of 3 and then 2 periods, and repeat the passes while they are productive.
+		// the windows solved at the same time are taken with a stride of the window width so that they seldom overlap.
+		ID batchSize = (max)(1, cfg.windowJobNum);
+		for (Scheduler::Phase phase : { Scheduler::Window3, Scheduler::Window2 }) {
+			if ((phase < resumePhase) || isTerminationRequested) { continue; }
+			ID width = (phase == Scheduler::Window3) ? 3 : 2;
+			ID stride = (batchSize > 1) ? width : 1;
+			List<List<ID>> windows;
+			for (ID offset = 0; offset < stride; ++offset) {
+				for (ID p = offset; p + width <= periodNum; p += stride) {
+					windows.push_back(List<ID>(width));
+					for (ID i = 0; i < width; ++i) { windows.back()[i] = p + i; }
+				}
+			}
+			ID windowNum = static_cast<ID>(windows.size());
+
+			scheduler.enter(phase, timer.restSeconds());
+			for (bool improved = true; improved && !scheduler.isTimeOut() && !isStopping();) {
+				improved = false;
+				for (ID w = 0; (w < windowNum) && !scheduler.isTimeOut() && !isStopping(); w += batchSize) {
+					ID restBatchNum = (windowNum - w + batchSize - 1) / batchSize;
+					double timeInSec = scheduler.restSeconds() / restBatchNum;
+					Price prevCost = aux.bestCost;
+					if (batchSize > 1) {
+						getNeighWithModels(sln, List<List<ID>>(windows.begin() + w, windows.begin() + (min)(w + batchSize, windowNum)), timeInSec);
+					} else {
+						getNeighWithModel(sln, aux.bestVisits, windows[w], timeInSec);
+					}
+					scheduler.record(prevCost, aux.bestCost);
+					if (Math::strongLess(aux.bestCost, prevCost)) { improved = true; }
+					checkpoint(scheduler, phase, false);
+				}
+			}
+			Log(LogSwitch::Szx::Search) << "phase " << Scheduler::phaseName(phase) << " takes "
+				<< scheduler.elapsedSeconds() << "/" << scheduler.budget << "s, gain=" << scheduler.gains[phase] << endl;
+			if (isTerminationRequested) { break; } // resume the interrupted phase from its first window.
+			resumePhase = static_cast<Scheduler::Phase>(phase + 1);
+			checkpoint(scheduler, resumePhase);
+		}
 
-		iteratedModel(sln);	// ɳģ
+		if (!isTerminationRequested) {
+			scheduler.enter(Scheduler::Local, timer.restSeconds());
+			if (!isLocalResumed) {
+				aux.curVisits = aux.bestVisits;
+				mixTabuSearch(aux.curVisits, aux.bestCost);
+				restartFromElites();
+			} else { // continue the tabu search from the restored current visits, tours and tabu memory.
+				Price curCost = callModel(aux.curVisits);
+				if (curCost >= 0) {
+					for (Price price : aux.tourPrices) { curCost += price; }
+					mixTabuSearch(aux.curVisits, curCost);
+				}
+			}
+			mixFinalSearch(scheduler);
+		}
+		if (isTerminationRequested) { checkpoint(scheduler, resumePhase); }
+		Log(LogSwitch::Szx::Search) << "model cache hit=" << aux.modelCache.getHitNum()
+			<< " miss=" << aux.modelCache.getMissNum() << " size=" << aux.modelCache.size() << endl;
+		Log(LogSwitch::Szx::Search) << "dual bound pruned " << aux.prunedNeighNum << "/" << aux.screenedNeighNum << " neighbors" << endl;
+
+		getBestSln(sln, aux.bestVisits);	// ԭʷŽ
+	}
+
+	void Solver::recordImprovement(Price cost, Improvement::Source source) {
+		lock_guard<mutex> improvementLock(improvementMutex);
+		// the workers find their own solutions, so only the ones better than all previous ones are improvements.
+		if (!improvements.empty() && !Math::strongLess(cost, improvements.back().cost)) { return; }
+		bestSlnTime = Timer::Clock::now();
+		improvements.push_back({ Timer::durationInSecond(timer.getStartTime(), bestSlnTime), cost, source });
+	}
+
+	Timer::TimePoint Solver::lastImprovementTime() {
+		lock_guard<mutex> improvementLock(improvementMutex);
+		return bestSlnTime;
+	}
 
-		for (ID p = 0; p < periodNum - 2; ++p) {// ģ
-			getNeighWithModel(sln, aux.bestVisits, { p,p + 1,p + 2 }, 180);
+	void Solver::streamSln(const Solution &sln) {
+		if (!slnWriter.isBetter(sln.totalCost)) { return; }
+		Problem::Output out;
+		sln.toOutput(out);
+		pb::Submission submission;
+		initSubmission(submission, sln.totalCost, timer.elapsedSeconds());
+		slnWriter.submit(submission, out);
+	}
+
+	void Solver::checkpoint(const Scheduler &scheduler, Scheduler::Phase resumePhase, bool force) {
+		if ((cfg.checkpointInterval <= 0) || env.slnPath.empty()) { return; }
+		if (!force && (Timer::durationInSecond(lastCheckpointTime, Timer::Clock::now()) < cfg.checkpointInterval)) { return; }
+		lock_guard<mutex> checkpointLock(checkpointMutex);
+		if (!saveCheckpoint(env.checkpointPath(), scheduler, resumePhase)) {
+			Log(LogSwitch::Szx::Search) << "fail to save checkpoint " << env.checkpointPath() << endl;
 		}
-		// ģ
-		for (ID i = 0; i < 2; ++i) {
-			for (ID p = 0; p < periodNum - 1; ++p) {
-				getNeighWithModel(sln, aux.bestVisits, { p,p + 1 }, 90);
+		lastCheckpointTime = Timer::Clock::now();
+	}
+
+	// the checkpoint is a text file of tagged lines, where the visit matrices are written as the period pattern of each node
+	// and the tabu tables are written as their latest set bits.
+	bool Solver::saveCheckpoint(const String &path, const Scheduler &scheduler, Scheduler::Phase resumePhase) const {
+		String tmpPath(path + ".tmp");
+		ofstream ofs(tmpPath);
+		if (!ofs.is_open()) { return false; }
+		ofs.precision(numeric_limits<Price>::max_digits10);
+
+		ofs << "checkpoint " << CheckpointVersion << '\n'
+			<< "instance " << env.friendlyInstName() << '\n'
+			<< "size " << periodNum << ' ' << nodeNum << '\n'
+			<< "phase " << resumePhase << '\n'
+			<< "spentSeconds";
+		for (int p = 0; p < Scheduler::PhaseNum; ++p) { ofs << ' ' << scheduler.spentSecondsIn(static_cast<Scheduler::Phase>(p)); }
+		ofs << '\n' << "gains";
+		for (int p = 0; p < Scheduler::PhaseNum; ++p) { ofs << ' ' << scheduler.gains[p]; }
+		ofs << '\n' << "bestCost " << aux.bestCost << '\n';
+
+		auto writeVisits = [&](const char *tag, const VisitMatrix &visits) {
+			ofs << tag;
+			for (ID n = 0; n < nodeNum; ++n) { ofs << ' ' << visits.pattern(n); }
+			ofs << '\n';
+		};
+		writeVisits("bestVisits", aux.bestVisits);
+		writeVisits("curVisits", aux.curVisits);
+
+		ofs << "tourPrices";
+		for (ID p = 0; p < periodNum; ++p) { ofs << ' ' << aux.tourPrices[p]; }
+		ofs << '\n' << "staleTours";
+		for (ID p = 0; p < periodNum; ++p) { ofs << ' ' << aux.staleTours[p]; }
+		ofs << '\n';
+		for (ID p = 0; p < periodNum; ++p) {
+			ofs << "curTour " << aux.curTours[p].size();
+			for (ID n : aux.curTours[p]) { ofs << ' ' << n; }
+			ofs << '\n';
+		}
+
+		ofs << "hashValues " << hashValue1 << ' ' << hashValue2 << ' ' << hashValue3 << '\n';
+		for (const TabuTable *table : { &H1, &H2, &H3 }) {
+			ofs << "tabu " << (table->setBits.end() - table->listedBegin());
+			for (auto i = table->listedBegin(); i != table->setBits.end(); ++i) { ofs << ' ' << *i; }
+			ofs << '\n';
+		}
+
+		ofs << "rand " << rand.rgen << '\n'
+			<< "end" << endl;
+		bool isWritten = ofs.good();
+		ofs.close();
+		return isWritten && System::replaceFile(tmpPath, path);
+	}
+
+	bool Solver::loadCheckpoint(const String &path, Scheduler &scheduler) {
+		ifstream ifs(path);
+		if (!ifs.is_open()) { return false; }
+
+		// read into the temporary states first so that a broken file leaves the solver untouched.
+		auto expect = [&](const char *tag) {
+			String word;
+			return (ifs >> word) && (word == tag);
+		};
+		int version = 0;
+		String instName;
+		ID periodNumber = 0, nodeNumber = 0;
+		int phase = 0;
+		if (!(expect("checkpoint") && (ifs >> version) && (version == CheckpointVersion))) { return false; }
+		if (!(expect("instance") && (ifs >> instName) && (instName == env.friendlyInstName()))) { return false; }
+		if (!(expect("size") && (ifs >> periodNumber >> nodeNumber) && (periodNumber == periodNum) && (nodeNumber == nodeNum))) { return false; }
+		if (!(expect("phase") && (ifs >> phase) && (phase >= Scheduler::Model) && (phase < Scheduler::PhaseNum))) { return false; }
+
+		double spentSeconds[Scheduler::PhaseNum];
+		if (!expect("spentSeconds")) { return false; }
+		for (int p = 0; p < Scheduler::PhaseNum; ++p) { if (!(ifs >> spentSeconds[p])) { return false; } }
+		Price gains[Scheduler::PhaseNum];
+		if (!expect("gains")) { return false; }
+		for (int p = 0; p < Scheduler::PhaseNum; ++p) { if (!(ifs >> gains[p]) || (gains[p] < 0)) { return false; } }
+
+		Price bestCost;
+		if (!(expect("bestCost") && (ifs >> bestCost))) { return false; }
+
+		VisitMatrix bestVisits(periodNum, nodeNum), curVisits(periodNum, nodeNum);
+		auto readVisits = [&](const char *tag, VisitMatrix &visits) {
+			if (!expect(tag)) { return false; }
+			for (ID n = 0; n < nodeNum; ++n) {
+				VisitMatrix::Word w;
+				if (!(ifs >> w)) { return false; }
+				visits.setPattern(n, w);
+			}
+			return true;
+		};
+		if (!(readVisits("bestVisits", bestVisits) && readVisits("curVisits", curVisits))) { return false; }
+
+		Arr<Price> tourPrices(periodNum);
+		if (!expect("tourPrices")) { return false; }
+		for (ID p = 0; p < periodNum; ++p) { if (!(ifs >> tourPrices[p])) { return false; } }
+		List<bool> staleTours(periodNum); // the tours repaired by TourRepair are re-optimized by LKH later.
+		if (!expect("staleTours")) { return false; }
+		for (ID p = 0; p < periodNum; ++p) {
+			int isStale = 0;
+			if (!(ifs >> isStale) || (isStale < 0) || (isStale > 1)) { return false; }
+			staleTours[p] = (isStale != 0);
+		}
+		Arr<List<ID>> curTours(periodNum);
+		for (ID p = 0; p < periodNum; ++p) {
+			size_t len = 0;
+			if (!(expect("curTour") && (ifs >> len) && (len <= static_cast<size_t>(nodeNum) + 1))) { return false; }
+			curTours[p].resize(len);
+			for (auto n = curTours[p].begin(); n != curTours[p].end(); ++n) {
+				if (!(ifs >> *n) || (*n < 0) || (*n >= nodeNum)) { return false; }
 			}
 		}
 
-		aux.curVisits = aux.bestVisits;
-		mixTabuSearch(aux.curVisits, aux.bestCost);
-		mixFinalSearch();
+		unsigned hashValues[3];
+		if (!(expect("hashValues") && (ifs >> hashValues[0] >> hashValues[1] >> hashValues[2]))) { return false; }
+		List<unsigned> setBits[3];
+		for (int t = 0; t < 3; ++t) {
+			size_t bitNum = 0;
+			if (!(expect("tabu") && (ifs >> bitNum) && (bitNum <= TabuTable::MaxListedBitNum))) { return false; }
+			setBits[t].resize(bitNum);
+			for (auto i = setBits[t].begin(); i != setBits[t].end(); ++i) {
+				if (!(ifs >> *i) || (*i >= BitSize)) { return false; }
+			}
+		}
 
-		getBestSln(sln, aux.bestVisits);	// ԭʷŽ
+		Random::Generator rgen;
+		if (!(expect("rand") && (ifs >> rgen) && expect("end"))) { return false; }
+
+		// commit the states.
+		scheduler.curPhase = static_cast<Scheduler::Phase>(phase);
+		copy(spentSeconds, spentSeconds + Scheduler::PhaseNum, scheduler.spentSeconds);
+		copy(gains, gains + Scheduler::PhaseNum, scheduler.gains);
+		aux.bestCost = bestCost;
+		aux.bestVisits = bestVisits;
+		aux.curVisits = curVisits;
+		aux.tourPrices = tourPrices;
+		aux.curTours = curTours;
+		aux.staleTours = staleTours;
+		hashValue1 = hashValues[0], hashValue2 = hashValues[1], hashValue3 = hashValues[2];
+		TabuTable *tables[] = { &H1, &H2, &H3 };
+		for (int t = 0; t < 3; ++t) {
+			tables[t]->init(BitSize);
+			for (unsigned i : setBits[t]) { tables[t]->set(i); }
+		}
+		rand.rgen = rgen;
+		return true;
 	}
 
 	bool Solver::optimize(Solution &sln, ID workerId) {
 		Log(LogSwitch::Szx::Framework) << "worker " << workerId << " starts." << endl;
-		sln.init(periodNum, input.vehicles_size(), Problem::MaxCost);
+		Profiler::Binding profilerBinding(profiler.worker(workerId));
+		AsyncLog::Binding logBinding(workerId);
+		sln.init(periodNum, inst.vehicleNum(), nodeNum, Problem::MaxCost);
 
 		// ȫLKH
-		static const String TspCacheDir("TspCache/");
-		System::makeSureDirExist(TspCacheDir);
-		tspSolver = new CachedTspSolver(nodeNum, TspCacheDir + env.friendlyInstName() + ".csv");
+		if (env.isTspCachePersistent) { System::makeSureDirExist(Environment::DefaultTspCacheDir()); }
+		initTspSolver(env.tspCachePath());
 
 		execSearch(sln);
 
+		profiler.addCacheStat(Profiler::TspCacheStat, tspSolver->getHitNum(), tspSolver->getMissNum());
 		delete tspSolver;
 		tspSolver = nullptr;
 
@@ -663,11 +1104,28 @@ namespace szx {
 		return true;
 	}
 
-	void Solver::iteratedModel(Solution &sln) {
-		ID vehicleNum = input.vehicles_size();
-		const auto &nodes(*input.mutable_nodes());
-		MpSolver::Configuration mpCfg(MpSolver::InternalSolver::GurobiMip, env.timeoutInSecond(), true, false);
-		MpSolver mp(mpCfg); mp.setMaxThread(4);
+	void Solver::initTspSolver(const String &cachePath) {
+		// the batches of a worker share the threads assigned to it, so that the solver never exceeds env.jobNum LKH threads.
+		int batchThreadNum = (max)(1, cfg.threadNumPerWorker);
+		tspSolver = cachePath.empty() ? new CachedTspSolver(nodeNum, batchThreadNum) : new CachedTspSolver(nodeNum, cachePath, batchThreadNum);
+		lkh::CoordList2D coords;
+		coords.reserve(nodeNum);
+		for (ID n = 0; n < nodeNum; ++n) {
+			coords.push_back(lkh::Coord2D(inst.x(n) * Precision, inst.y(n) * Precision));
+		}
+		tspSolver->initCandidateGraph(coords);
+		lkh::AdjMat costMatrix(nodeNum, nodeNum);
+		for (ID n = 0; n < nodeNum; ++n) {
+			for (ID m = 0; m < nodeNum; ++m) { costMatrix.at(n, m) = static_cast<lkh::Weight>(aux.routingCost.at(n, m)); }
+		}
+		tspSolver->initCostMatrix(costMatrix);
+	}
+
+	void Solver::iteratedModel(Solution &sln, double timeInSec) {
+		ID vehicleNum = inst.vehicleNum();
+		// the time limit only applies after the first feasible solution is found.
+		MpSolver::Configuration mpCfg(MpSolver::InternalSolver::GurobiMip, timer.restSeconds(), true, false);
+		MpSolver mp(mpCfg); mp.setMaxThread(cfg.mipThreadNum);
 
 		// delivery[p, v, n] is the quantity delivered to node n at period p by vehicle v.
 		Arr2D<Arr<Dvar>> delivery(periodNum, vehicleNum, Arr<Dvar>(nodeNum));
@@ -682,19 +1140,19 @@ namespace szx {
 		// add decision variables.
 		for (ID p = 0; p < periodNum; ++p) {
 			for (ID v = 0; v < vehicleNum; ++v) {
-				for (ID n = 0; n < input.depotnum(); ++n) {
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
+				for (ID n = 0; n < inst.depotNum(); ++n) {
+					Quantity capacity = inst.deliveryCapacity(v, n);
 					delivery[p][v][n] = mp.addVar(MpSolver::VariableType::Real, -capacity, 0);
 				}
-				for (ID n = input.depotnum(); n < nodeNum; ++n) {
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
+				for (ID n = inst.depotNum(); n < nodeNum; ++n) {
+					Quantity capacity = aux.forbiddenVisits.at(p, n) ? 0 : inst.deliveryCapacity(v, n);
 					delivery[p][v][n] = mp.addVar(MpSolver::VariableType::Real, 0, capacity);
 				}
 				Arr2D<Dvar> &xpv(x.at(p, v));
 				for (ID n = 0; n < nodeNum; ++n) {
 					for (ID m = 0; m < nodeNum; ++m) {
 						if (n == m) { continue; }
-						xpv.at(n, m) = mp.addVar(MpSolver::VariableType::Bool, 0, 1);
+						xpv.at(n, m) = mp.addVar(MpSolver::VariableType::Bool, 0, isVisitable(p, n, m) ? 1 : 0);
 					}
 				}
 			}
@@ -702,14 +1160,14 @@ namespace szx {
 
 		// add constraints.
 		for (ID n = 0; n < nodeNum; ++n) {
-			Expr quantity = nodes[n].initquantity();
+			Expr quantity = inst.initQuantity(n);
 			for (ID p = 0; p < periodNum; ++p) {
 				for (ID v = 0; v < vehicleNum; ++v) {
 					quantity += delivery[p][v][n];
 				}
 				// node capacity constraint.
-				mp.addConstraint(quantity <= nodes[n].capacity());
-				quantity -= nodes[n].demands(p);
+				mp.addConstraint(quantity <= inst.capacity(n));
+				quantity -= inst.demand(p, n);
 				mp.addConstraint(0 <= quantity);
 				quantityLevel[n][p] = quantity;
 			}
@@ -726,6 +1184,16 @@ namespace szx {
 			}
 		}
 
+		for (ID p = 0; p < periodNum; ++p) {
+			for (ID n = inst.depotNum(); n < nodeNum; ++n) {
+				if (!aux.forcedVisits.at(p, n)) { continue; }
+				Expr quantity;
+				for (ID v = 0; v < vehicleNum; ++v) { quantity += delivery[p][v][n]; }
+				// forced visit constraint.
+				mp.addConstraint(quantity >= 1);
+			}
+		}
+
 		for (ID p = 0; p < periodNum; ++p) {
 			for (ID v = 0; v < vehicleNum; ++v) {
 				Arr2D<Dvar> &xpv(x.at(p, v));
@@ -740,10 +1208,10 @@ namespace szx {
 					// path connectivity constraint.
 					mp.addConstraint(inDegree == outDegree); // OPTIMIZE[szx][0]: use undirected graph version? (degree == 2)
 					// delivery precondition constraint.
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
-					double quantityCoef = (n >= input.depotnum()) ? 1 : -1;
+					Quantity capacity = inst.deliveryCapacity(v, n);
+					double quantityCoef = (n >= inst.depotNum()) ? 1 : -1;
 					mp.addConstraint(quantityCoef * delivery[p][v][n] <= capacity * inDegree);
-					if (n >= input.depotnum()) {
+					if (n >= inst.depotNum()) {
 						// visit precondition constraint.
 						mp.addConstraint(delivery[p][v][n] >= inDegree); // OPTIMIZE[szx][2]: omit it since it will be satisfied automatically?
 					}
@@ -758,7 +1226,7 @@ namespace szx {
 		Expr holdingCost = aux.initHoldingCost;
 		for (ID n = 0; n < nodeNum; ++n) {
 			for (ID p = 0; p < periodNum; ++p) {
-				holdingCost += (nodes[n].holdingcost() * quantityLevel.at(n, p));
+				holdingCost += (inst.holdingCost(n) * quantityLevel.at(n, p));
 			}
 		}
 		Expr routingCost;
@@ -778,7 +1246,7 @@ namespace szx {
 		double tourcostFactor = 1 + 1.0*rand.pick(8, 13) / 10;
 		obj = holdingCost + tourcostFactor * routingCost;
 		//obj = holdingCost + 1.5 * routingCost;
-		mp.addObjective(obj, MpSolver::OptimaOrientation::Minimize, 0, 0, 0, env.timeoutInSecond());
+		mp.addObjective(obj, MpSolver::OptimaOrientation::Minimize, 0, 0, 0, timer.restSeconds());
 
 		// add callbacks.
 		auto subTourHandler = [&](MpSolver::MpEvent &e) {
@@ -806,7 +1274,7 @@ namespace szx {
 							for (ID n = 0; n < nodeNum; ++n) {
 								if (prev == n) { continue; }
 								if (!e.isTrue(xpv.at(prev, n))) { continue; }
-								if (s >= input.depotnum()) { tour.push_back(n); } // the sub-tour containing depots should not be eliminated.
+								if (s >= inst.depotNum()) { tour.push_back(n); } // the sub-tour containing depots should not be eliminated.
 								prev = n;
 								visited[n] = true;
 								break;
@@ -838,53 +1306,40 @@ namespace szx {
 		};
 
 		Solution curSln;
-		curSln.init(periodNum, vehicleNum);
+		curSln.init(periodNum, vehicleNum, nodeNum);
+		// the buffers are reused among the callbacks to avoid reallocating the node sets and tours for each solution.
+		List<CachedTspSolver::NodeSetRequest> requests(periodNum * vehicleNum);
+		List<lkh::Tour> tours;
 		auto nodeSetHandler = [&](MpSolver::MpEvent &e) {
-			lkh::CoordList2D coords; // OPTIMIZE[szx][3]: use adjacency matrix to avoid re-calculation and different rounding?
-			coords.reserve(nodeNum);
-			List<ID> nodeIdMap(nodeNum);
-			List<bool> containNode(nodeNum);
-			lkh::Tour tour;
-			//Expr nodeDiff;
-
-			curSln.totalCost = 0;
+			Profiler::ScopedTimer<LogSwitch::Prof::MipCallback> probe(Profiler::MipSolution);
 			for (ID p = 0; p < periodNum; ++p) {
-				auto &periodRoute(*curSln.mutable_periodroutes(p));
 				for (ID v = 0; v < vehicleNum; ++v) {
 					Arr2D<Dvar> &xpv(x.at(p, v));
-					coords.clear();
-					fill(containNode.begin(), containNode.end(), false);
+					CachedTspSolver::NodeSetRequest &request(requests[p * vehicleNum + v]);
+					request.containNode.assign(nodeNum, false);
 					for (ID n = 0; n < nodeNum; ++n) {
-						bool visited = false;
 						for (ID m = 0; m < nodeNum; ++m) {
 							if (n == m) { continue; }
 							if (!e.isTrue(xpv.at(n, m))) { continue; }
-							nodeIdMap[coords.size()] = n;
-							containNode[n] = true;
-							coords.push_back(lkh::Coord2D(nodes[n].x() * Precision, nodes[n].y() * Precision));
-							visited = true;
+							request.containNode[n] = true;
 							break;
 						}
-						//nodeDiff += (visited ? (1 - degrees[p][v][n]) : degrees[p][v][n]);
-					}
-					auto &route(*periodRoute.mutable_vehicleroutes(v));
-					route.clear_deliveries();
-					if (coords.size() > 2) { // repair the relaxed solution.
-						tspSolver->solve(tour, containNode, coords, [&](ID n) { return nodeIdMap[n]; });
-					}
-					else if (coords.size() == 2) { // trivial cases.
-						tour.nodes.resize(2);
-						tour.nodes[0] = nodeIdMap[0];
-						tour.nodes[1] = nodeIdMap[1];
-					}
-					else {
-						continue;
 					}
+					buildTspRequest(request);
+				}
+			}
+			// repair the relaxed solution.
+			tspSolver->solveBatch(tours, requests);
+
+			curSln.totalCost = 0;
+			for (ID p = 0; p < periodNum; ++p) {
+				for (ID v = 0; v < vehicleNum; ++v) {
+					curSln.clearRoute(p, v);
+					lkh::Tour &tour(tours[p * vehicleNum + v]);
+					if (tour.nodes.size() < 2) { continue; }
 					tour.nodes.push_back(tour.nodes.front());
 					for (auto n = tour.nodes.begin(), m = n + 1; m != tour.nodes.end(); ++n, ++m) {
-						auto &d(*route.add_deliveries());
-						d.set_node(*m);
-						d.set_quantity(lround(e.getValue(delivery[p][v][*m])));
+						curSln.addDelivery(p, v, *m, lround(e.getValue(delivery[p][v][*m])));
 						curSln.totalCost += aux.routingCost.at(*n, *m);
 					}
 				}
@@ -896,26 +1351,102 @@ namespace szx {
 			curSln.totalCost += e.getValue(holdingCost);
 
 			if (Math::strongLess(curSln.totalCost, sln.totalCost)) {
-				bestSlnTime = szx::Timer::Clock::now();
-				Log(LogSwitch::Szx::Model) << "By model, opt=" << curSln.totalCost << endl;
+				recordImprovement(curSln.totalCost, Improvement::Model);
+				AsyncLog::write(LogSwitch::Szx::Model, AsyncLog::Model, "opt", curSln.totalCost);
 				std::swap(curSln, sln);
+				streamSln(sln);
 			}
 		};
 
+		Timer::TimePoint startTime = Timer::Clock::now();
+		double stallSecond = Scheduler::stallSecond(timeInSec);
+		auto stallHandler = [&](MpSolver::MpEvent &e) {
+			Profiler::ScopedTimer<LogSwitch::Prof::MipCallback> probe(Profiler::MipProgress);
+			if (isTerminationRequested) { e.stop(); return; }
+			if (sln.totalCost >= Problem::MaxCost) { return; } // keep going until the first feasible solution.
+			Timer::TimePoint now = Timer::Clock::now();
+			Timer::TimePoint lastImprovement = (max)(startTime, lastImprovementTime());
+			if ((Timer::durationInSecond(startTime, now) > timeInSec)
+				|| (Timer::durationInSecond(lastImprovement, now) > stallSecond)) { e.stop(); }
+		};
+
 		mp.setMipSlnEvent(nodeSetHandler);
+		mp.setMipProgressEvent(stallHandler);
+		if (cfg.elitePoolSize > 0) { mp.setMaxSolutionPoolSize(cfg.elitePoolSize); }
 		mp.optimize();
 
+		if (cfg.elitePoolSize > 0) {
+			List<ID> pl(periodNum);
+			for (ID p = 0; p < periodNum; ++p) { pl[p] = p; }
+			harvestPool(mp, x, pl, aux.bestVisits);
+		}
+
 		initialSln(sln);	// ʼ visits, bestCost and allTourCost
 	}
 
-	void Solver::getNeighWithModel(Solution &sln, const Arr2D<ID> &visits, const List<ID> &pl, double timeInSec) {
-		Log(LogSwitch::Szx::Model) << "change period";
-		for (ID p : pl) { Log(LogSwitch::Szx::Model) << " " << p; } Log(LogSwitch::Szx::Model) << endl;
+	void Solver::getNeighWithModel(Solution &sln, const VisitMatrix &visits, const List<ID> &pl, double timeInSec) {
+		double tourcostFactor = 1 + 1.0*rand.pick(8, 13) / 10;
+		solveWindow(sln, visits, pl, timeInSec, cfg.mipThreadNum, tourcostFactor);
+		initialSln(sln);
+	}
+
+	void Solver::getNeighWithModels(Solution &sln, const List<List<ID>> &windows, double timeInSec) {
+		ID windowNum = static_cast<ID>(windows.size());
+		List<Solution> slns(windowNum, sln);
+		List<double> tourcostFactors(windowNum);
+		for (auto f = tourcostFactors.begin(); f != tourcostFactors.end(); ++f) { *f = 1 + 1.0*rand.pick(8, 13) / 10; }
+		List<char> improved(windowNum, false);
+
+		// the windows only read the shared search states (aux.bestVisits and aux.tourPrices are fixed here).
+		Profiler::Worker *profilerWorker = Profiler::boundWorker();
+		int logWorker = AsyncLog::boundWorker();
+		List<thread> threadList;
+		threadList.reserve(windowNum);
+		for (ID w = 0; w < windowNum; ++w) {
+			threadList.emplace_back([&, w]() {
+				Profiler::Binding profilerBinding(profilerWorker);
+				AsyncLog::Binding logBinding(logWorker);
+				improved[w] = solveWindow(slns[w], aux.bestVisits, windows[w], timeInSec, cfg.mipThreadNum, tourcostFactors[w]);
+			});
+		}
+		for (auto t = threadList.begin(); t != threadList.end(); ++t) { t->join(); }
+
+		List<ID> order;
+		for (ID w = 0; w < windowNum; ++w) { if (improved[w]) { order.push_back(w); } }
+		if (order.empty()) { return; }
+		sort(order.begin(), order.end(), [&](ID l, ID r) { return slns[l].totalCost < slns[r].totalCost; });
+		// start from the best window and merge the other improved windows on disjoint periods if the combination is better.
+		std::swap(sln, slns[order.front()]);
+		VisitMatrix mergedVisits(periodNum, nodeNum);
+		getVisits(sln, mergedVisits);
+		List<bool> merged(periodNum, false);
+		for (ID p : windows[order.front()]) { merged[p] = true; }
+		for (auto w = order.begin() + 1; w != order.end(); ++w) {
+			const List<ID> &pl(windows[*w]);
+			if (any_of(pl.begin(), pl.end(), [&](ID p) { return merged[p]; })) { continue; }
+			VisitMatrix visits(periodNum, nodeNum);
+			getVisits(slns[*w], visits);
+			VisitMatrix combinedVisits(mergedVisits);
+			for (ID p : pl) { combinedVisits.copyPeriod(visits, p); }
+			Solution combinedSln(sln);
+			if (!getBestSln(combinedSln, combinedVisits)) { continue; }
+			if (!Math::strongLess(combinedSln.totalCost, sln.totalCost)) { continue; }
+			AsyncLog::write(LogSwitch::Szx::Model, AsyncLog::Window, "merge", combinedSln.totalCost, pl.front());
+			recordImprovement(combinedSln.totalCost, Improvement::Window);
+			std::swap(sln, combinedSln);
+			std::swap(mergedVisits, combinedVisits);
+			for (ID p : pl) { merged[p] = true; }
+		}
+
+		initialSln(sln);
+	}
+
+	bool Solver::solveWindow(Solution &sln, const VisitMatrix &visits, const List<ID> &pl, double timeInSec, int threadNum, double tourcostFactor) {
+		for (ID p : pl) { AsyncLog::write(LogSwitch::Szx::Model, AsyncLog::Window, "change", sln.totalCost, p); }
 
-		ID vehicleNum = input.vehicles_size(), chPNum = pl.size();
-		const auto &nodes(*input.mutable_nodes());
+		ID vehicleNum = inst.vehicleNum(), chPNum = pl.size();
 		MpSolver::Configuration mpCfg(MpSolver::InternalSolver::GurobiMip, timeInSec, true, false);
-		MpSolver mp(mpCfg); mp.setMaxThread(4);
+		MpSolver mp(mpCfg); mp.setMaxThread(threadNum);
 
 		// delivery[p, v, n] is the quantity delivered to node n at period p by vehicle v.
 		Arr2D<Arr<Dvar>> delivery(periodNum, vehicleNum, Arr<Dvar>(nodeNum));
@@ -927,12 +1458,12 @@ namespace szx {
 		// add decision variables.
 		for (ID p = 0; p < periodNum; ++p) {
 			for (ID v = 0; v < vehicleNum; ++v) {
-				for (ID n = 0; n < input.depotnum(); ++n) {
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
+				for (ID n = 0; n < inst.depotNum(); ++n) {
+					Quantity capacity = inst.deliveryCapacity(v, n);
 					delivery[p][v][n] = mp.addVar(MpSolver::VariableType::Real, -capacity, 0);
 				}
-				for (ID n = input.depotnum(); n < nodeNum; ++n) {
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
+				for (ID n = inst.depotNum(); n < nodeNum; ++n) {
+					Quantity capacity = aux.forbiddenVisits.at(p, n) ? 0 : inst.deliveryCapacity(v, n);
 					delivery[p][v][n] = mp.addVar(MpSolver::VariableType::Real, 0, capacity);
 				}
 			}
@@ -944,7 +1475,7 @@ namespace szx {
 				for (ID n = 0; n < nodeNum; ++n) {
 					for (ID m = 0; m < nodeNum; ++m) {
 						if (n == m) { continue; }
-						xpv.at(n, m) = mp.addVar(MpSolver::VariableType::Bool, 0, 1);
+						xpv.at(n, m) = mp.addVar(MpSolver::VariableType::Bool, 0, isVisitable(pl[i], n, m) ? 1 : 0);
 					}
 				}
 			}
@@ -952,14 +1483,14 @@ namespace szx {
 
 		// add constraints.
 		for (ID n = 0; n < nodeNum; ++n) {
-			Expr quantity = nodes[n].initquantity();
+			Expr quantity = inst.initQuantity(n);
 			for (ID p = 0; p < periodNum; ++p) {
 				for (ID v = 0; v < vehicleNum; ++v) {
 					quantity += delivery[p][v][n];
 				}
 				// node capacity constraint.
-				mp.addConstraint(quantity <= nodes[n].capacity());
-				quantity -= nodes[n].demands(p);
+				mp.addConstraint(quantity <= inst.capacity(n));
+				quantity -= inst.demand(p, n);
 				mp.addConstraint(0 <= quantity);
 				quantityLevel[n][p] = quantity;
 			}
@@ -976,6 +1507,16 @@ namespace szx {
 			}
 		}
 
+		for (ID p = 0; p < periodNum; ++p) {
+			for (ID n = inst.depotNum(); n < nodeNum; ++n) {
+				if (!aux.forcedVisits.at(p, n)) { continue; }
+				Expr quantity;
+				for (ID v = 0; v < vehicleNum; ++v) { quantity += delivery[p][v][n]; }
+				// forced visit constraint.
+				mp.addConstraint(quantity >= 1);
+			}
+		}
+
 		for (ID i = 0; i < chPNum; ++i) {
 			for (ID v = 0; v < vehicleNum; ++v) {
 				Arr2D<Dvar> &xpv(x.at(i, v));
@@ -989,10 +1530,10 @@ namespace szx {
 					// path connectivity constraint.
 					mp.addConstraint(inDegree == outDegree);
 					// delivery precondition constraint.
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
-					double quantityCoef = (n >= input.depotnum()) ? 1 : -1;
+					Quantity capacity = inst.deliveryCapacity(v, n);
+					double quantityCoef = (n >= inst.depotNum()) ? 1 : -1;
 					mp.addConstraint(quantityCoef * delivery[pl[i]][v][n] <= capacity * inDegree);
-					if (n >= input.depotnum()) {
+					if (n >= inst.depotNum()) {
 						// visit precondition constraint.
 						mp.addConstraint(delivery[pl[i]][v][n] >= inDegree);
 					}
@@ -1007,8 +1548,8 @@ namespace szx {
 			for (ID v = 0; v < vehicleNum; ++v) {
 				for (ID n = 0; n < nodeNum; ++n) {
 					// delivery precondition constraint.
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
-					double quantityCoef = (n >= input.depotnum()) ? 1 : -1;
+					Quantity capacity = inst.deliveryCapacity(v, n);
+					double quantityCoef = (n >= inst.depotNum()) ? 1 : -1;
 					mp.addConstraint(quantityCoef * delivery[p][v][n] <= capacity * visits[p][n]);
 				}
 			}
@@ -1019,7 +1560,7 @@ namespace szx {
 		Expr holdingCost = aux.initHoldingCost;
 		for (ID n = 0; n < nodeNum; ++n) {
 			for (ID p = 0; p < periodNum; ++p) {
-				holdingCost += (nodes[n].holdingcost() * quantityLevel.at(n, p));
+				holdingCost += (inst.holdingCost(n) * quantityLevel.at(n, p));
 			}
 		}
 		Expr routingCost;
@@ -1039,11 +1580,46 @@ namespace szx {
 		}
 
 
-		double tourcostFactor = 1 + 1.0*rand.pick(8, 13) / 10;
 		obj = holdingCost + tourcostFactor * routingCost;
 		//obj = holdingCost + 1.5 * routingCost;
 		mp.addObjective(obj, MpSolver::OptimaOrientation::Minimize, 0, 0, 0, timeInSec);
 
+		// warm start from the incumbent so that the MIP can prune against its cost from the beginning.
+		List<ID> succ(nodeNum);
+		for (ID i = 0; i < chPNum; ++i) {
+			for (ID v = 0; v < vehicleNum; ++v) {
+				Arr2D<Dvar> &xpv(x.at(i, v));
+				fill(succ.begin(), succ.end(), -1);
+				ID len = sln.routeLen(pl[i], v);
+				const ID *delivs = sln.routeNodes(pl[i], v);
+				const Quantity *quantities = sln.routeQuantities(pl[i], v);
+				ID prev = (len > 0) ? delivs[len - 1] : 0;
+				for (ID d = 0; d < len; ++d) {
+					// skip the visits without delivery since they violate the visit precondition constraint.
+					if ((delivs[d] >= inst.depotNum()) && (quantities[d] <= 0)) { continue; }
+					if (delivs[d] == prev) { continue; }
+					succ[prev] = delivs[d];
+					prev = delivs[d];
+				}
+				for (ID n = 0; n < nodeNum; ++n) {
+					for (ID m = 0; m < nodeNum; ++m) {
+						if (n == m) { continue; }
+						double value = (succ[n] == m) ? 1 : 0;
+						mp.setInitValue(xpv.at(n, m), value);
+						if (cfg.mipHint) { mp.setHintValue(xpv.at(n, m), value); }
+					}
+				}
+			}
+		}
+		for (ID p = 0; p < periodNum; ++p) {
+			for (ID v = 0; v < vehicleNum; ++v) {
+				for (ID n = 0; n < nodeNum; ++n) { mp.setInitValue(delivery[p][v][n], 0); }
+				const ID *delivs = sln.routeNodes(p, v);
+				const Quantity *quantities = sln.routeQuantities(p, v);
+				for (ID d = 0; d < sln.routeLen(p, v); ++d) { mp.setInitValue(delivery[p][v][delivs[d]], quantities[d]); }
+			}
+		}
+
 		// add callbacks.
 		auto subTourHandler = [&](MpSolver::MpEvent &e) {
 			enum EliminationPolicy { // OPTIMIZE[szx][0]: first sub-tour, best sub-tour or all sub-tours?
@@ -1071,7 +1647,7 @@ namespace szx {
 							for (ID n = 0; n < nodeNum; ++n) {
 								if (prev == n) { continue; }
 								if (!e.isTrue(xpv.at(prev, n))) { continue; }
-								if (s >= input.depotnum()) { tour.push_back(n); } // the sub-tour containing depots should not be eliminated.
+								if (s >= inst.depotNum()) { tour.push_back(n); } // the sub-tour containing depots should not be eliminated.
 								prev = n;
 								visited[n] = true;
 								break;
@@ -1102,51 +1678,42 @@ namespace szx {
 			}
 		};
 
-		Solution curSln; copySln(curSln, sln);
+		bool isImproved = false;
+		Timer::TimePoint lastImprovement = Timer::Clock::now();
+		Solution curSln(sln);
+		// reuse the buffers among the callbacks like `iteratedModel()`.
+		List<CachedTspSolver::NodeSetRequest> requests(chPNum * vehicleNum);
+		List<lkh::Tour> tours;
 		auto nodeSetHandler = [&](MpSolver::MpEvent &e) {
-			lkh::CoordList2D coords;
-			coords.reserve(nodeNum);
-			List<ID> nodeIdMap(nodeNum);
-			List<bool> containNode(nodeNum);
-			lkh::Tour tour;
-
-			curSln.totalCost = 0;
+			Profiler::ScopedTimer<LogSwitch::Prof::MipCallback> probe(Profiler::MipSolution);
 			for (ID i = 0; i < chPNum; ++i) {
-				auto &periodRoute(*curSln.mutable_periodroutes(pl[i]));
 				for (ID v = 0; v < vehicleNum; ++v) {
 					Arr2D<Dvar> &xpv(x.at(i, v));
-					coords.clear();
-					fill(containNode.begin(), containNode.end(), false);
+					CachedTspSolver::NodeSetRequest &request(requests[i * vehicleNum + v]);
+					request.containNode.assign(nodeNum, false);
 					for (ID n = 0; n < nodeNum; ++n) {
-						bool visited = false;
 						for (ID m = 0; m < nodeNum; ++m) {
 							if (n == m) { continue; }
 							if (!e.isTrue(xpv.at(n, m))) { continue; }
-							nodeIdMap[coords.size()] = n;
-							containNode[n] = true;
-							coords.push_back(lkh::Coord2D(nodes[n].x() * Precision, nodes[n].y() * Precision));
-							visited = true;
+							request.containNode[n] = true;
 							break;
 						}
 					}
-					auto &route(*periodRoute.mutable_vehicleroutes(v));
-					route.clear_deliveries();
-					if (coords.size() > 2) { // repair the relaxed solution.
-						tspSolver->solve(tour, containNode, coords, [&](ID n) { return nodeIdMap[n]; });
-					}
-					else if (coords.size() == 2) { // trivial cases.
-						tour.nodes.resize(2);
-						tour.nodes[0] = nodeIdMap[0];
-						tour.nodes[1] = nodeIdMap[1];
-					}
-					else {
-						continue;
-					}
+					buildTspRequest(request);
+				}
+			}
+			// repair the relaxed solution.
+			tspSolver->solveBatch(tours, requests);
+
+			curSln.totalCost = 0;
+			for (ID i = 0; i < chPNum; ++i) {
+				for (ID v = 0; v < vehicleNum; ++v) {
+					curSln.clearRoute(pl[i], v);
+					lkh::Tour &tour(tours[i * vehicleNum + v]);
+					if (tour.nodes.size() < 2) { continue; }
 					tour.nodes.push_back(tour.nodes.front());
 					for (auto n = tour.nodes.begin(), m = n + 1; m != tour.nodes.end(); ++n, ++m) {
-						auto &d(*route.add_deliveries());
-						d.set_node(*m);
-						d.set_quantity(lround(e.getValue(delivery[pl[i]][v][*m])));
+						curSln.addDelivery(pl[i], v, *m, lround(e.getValue(delivery[pl[i]][v][*m])));
 						curSln.totalCost += aux.routingCost.at(*n, *m);
 					}
 				}
@@ -1155,9 +1722,10 @@ namespace szx {
 				if (find(pl.begin(), pl.end(), p) != pl.end()) { continue; }
 				curSln.totalCost += aux.tourPrices[p];
 				for (ID v = 0; v < vehicleNum; ++v) {
-					auto &delivs(*curSln.mutable_periodroutes(p)->mutable_vehicleroutes(v)->mutable_deliveries());
-					for (auto n = delivs.begin(); n != delivs.end(); ++n) {
-						n->set_quantity(lround(e.getValue(delivery[p][v][n->node()])));
+					const ID *delivs = curSln.routeNodes(p, v);
+					Quantity *quantities = curSln.routeQuantities(p, v);
+					for (ID d = 0; d < curSln.routeLen(p, v); ++d) {
+						quantities[d] = lround(e.getValue(delivery[p][v][delivs[d]]));
 					}
 				}
 			}
@@ -1165,21 +1733,101 @@ namespace szx {
 			curSln.totalCost += e.getValue(holdingCost);
 
 			if (Math::strongLess(curSln.totalCost, sln.totalCost)) {
-				bestSlnTime = szx::Timer::Clock::now();
-				Log(LogSwitch::Szx::Model) << "By " << chPNum << " periods neighbor, opt=" << curSln.totalCost << endl;
+				isImproved = true;
+				lastImprovement = szx::Timer::Clock::now();
+				recordImprovement(curSln.totalCost, Improvement::Window);
+				AsyncLog::write(LogSwitch::Szx::Model, AsyncLog::Window, "opt", curSln.totalCost, chPNum);
 				std::swap(curSln, sln);
+				streamSln(sln);
 			}
 		};
 
+		double stallSecond = Scheduler::stallSecond(timeInSec);
+		auto stallHandler = [&](MpSolver::MpEvent &e) {
+			Profiler::ScopedTimer<LogSwitch::Prof::MipCallback> probe(Profiler::MipProgress);
+			if ((Timer::durationInSecond(lastImprovement, Timer::Clock::now()) > stallSecond) || isTerminationRequested) { e.stop(); }
+		};
+
 		mp.setMipSlnEvent(nodeSetHandler);
+		mp.setMipProgressEvent(stallHandler);
+		if (cfg.elitePoolSize > 0) { mp.setMaxSolutionPoolSize(cfg.elitePoolSize); }
 		mp.optimize();
 
-		initialSln(sln);
+		if (cfg.elitePoolSize > 0) { harvestPool(mp, x, pl, visits); }
+
+		return isImproved;
+	}
+
+	void Solver::harvestPool(MpSolver &mp, Arr2D<Arr2D<Dvar>> &x, const List<ID> &pl, const VisitMatrix &visits) {
+		ID vehicleNum = inst.vehicleNum();
+		int slnNum = (min)(mp.getSolutionCount(), cfg.elitePoolSize);
+		for (int s = 0; s < slnNum; ++s) {
+			mp.selectAltSolution(s);
+			VisitMatrix elite(visits); // the periods out of the model keep the given visits.
+			for (ID i = 0; i < static_cast<ID>(pl.size()); ++i) {
+				elite.clearPeriod(pl[i]);
+				elite[pl[i]][0] = 1;
+				for (ID v = 0; v < vehicleNum; ++v) {
+					Arr2D<Dvar> &xpv(x.at(i, v));
+					for (ID n = 0; n < nodeNum; ++n) {
+						for (ID m = 0; m < nodeNum; ++m) {
+							if (n == m) { continue; }
+							if (mp.getAltValue(xpv.at(n, m)) > 0.5) { elite[pl[i]][n] = 1; break; }
+						}
+					}
+				}
+			}
+			addElite(elite, mp.getAltObjectiveValue(s));
+		}
+	}
+
+	void Solver::addElite(const VisitMatrix &visits, Price cost) {
+		unsigned signature[3] = { hash(visits, gamma1), hash(visits, gamma2), hash(visits, gamma3) };
+
+		lock_guard<mutex> eliteGuard(aux.eliteMutex);
+		for (auto e = aux.elites.begin(); e != aux.elites.end(); ++e) {
+			if (equal(signature, signature + 3, e->signature)) { return; } // duplicated.
+		}
+		if (aux.elites.size() >= MaxEliteNum) { // replace the worst one.
+			auto worst = max_element(aux.elites.begin(), aux.elites.end(), [](const Elite &l, const Elite &r) { return l.cost < r.cost; });
+			if (cost >= worst->cost) { return; }
+			aux.elites.erase(worst);
+		}
+		aux.elites.push_back({ visits, cost, { signature[0], signature[1], signature[2] } });
 	}
 
-	Price Solver::callModel(Arr2D<int> &visits) {
-		ID vehicleNum = input.vehicles_size();
-		const auto &nodes(*input.mutable_nodes());
+	void Solver::restartFromElites() {
+		sort(aux.elites.begin(), aux.elites.end(), [](const Elite &l, const Elite &r) { return l.cost < r.cost; });
+		Log(LogSwitch::Szx::Search) << "restart from " << aux.elites.size() << " elites." << endl;
+		for (auto e = aux.elites.begin(); (e != aux.elites.end()) && !isStopping(); ++e) {
+			if (isTabu(e->visits)) { continue; } // the incumbent or the ones that have been searched.
+			aux.curVisits = e->visits;
+			Price modelCost = callModel(aux.curVisits);
+			if (modelCost < 0) { continue; }
+			Price totalCost = modelCost + callLKH(aux.curVisits);
+			if (Math::strongLess(totalCost, aux.bestCost)) {
+				recordImprovement(totalCost, Improvement::Elite);
+				aux.bestCost = totalCost;
+				aux.bestVisits = aux.curVisits;
+				AsyncLog::write(LogSwitch::Szx::Opt, AsyncLog::Elite, "opt", aux.bestCost);
+			}
+			mixTabuSearch(aux.curVisits, totalCost);
+		}
+		aux.elites.clear();
+	}
+
+	Price Solver::callModel(const VisitMatrix &visits, Arr2D<Price> *visitDuals) {
+		ModelCache::Signature signature = visits.signature();
+		Price cachedCost;
+		bool isCached;
+		{
+			Profiler::ScopedTimer<LogSwitch::Prof::Cache> probe(Profiler::ModelCacheLookup);
+			isCached = !visitDuals && aux.modelCache.get(cachedCost, signature);
+		}
+		if (isCached) { return cachedCost; }
+		Profiler::ScopedTimer<LogSwitch::Prof::Model> probe(Profiler::CallModel);
+
+		ID vehicleNum = inst.vehicleNum();
 		MpSolver::Configuration mpCfg;
 		MpSolver mp(mpCfg);
 
@@ -1191,12 +1839,12 @@ namespace szx {
 		// add decision variables.
 		for (ID p = 0; p < periodNum; ++p) {
 			for (ID v = 0; v < vehicleNum; ++v) {
-				for (ID n = 0; n < input.depotnum(); ++n) {
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
+				for (ID n = 0; n < inst.depotNum(); ++n) {
+					Quantity capacity = inst.deliveryCapacity(v, n);
 					delivery[p][v][n] = mp.addVar(MpSolver::VariableType::Real, -capacity, 0);
 				}
-				for (ID n = input.depotnum(); n < nodeNum; ++n) {
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
+				for (ID n = inst.depotNum(); n < nodeNum; ++n) {
+					Quantity capacity = inst.deliveryCapacity(v, n);
 					delivery[p][v][n] = mp.addVar(MpSolver::VariableType::Real, 0, capacity);
 				}
 			}
@@ -1204,28 +1852,32 @@ namespace szx {
 
 		// add constraints.
 		for (ID n = 0; n < nodeNum; ++n) {
-			Expr quantity = nodes[n].initquantity();
+			Expr quantity = inst.initQuantity(n);
 			for (ID p = 0; p < periodNum; ++p) {
 				for (ID v = 0; v < vehicleNum; ++v) {
 					quantity += delivery[p][v][n];
 				}
 				// node capacity constraint.
-				mp.addConstraint(quantity <= nodes[n].capacity());
-				quantity -= nodes[n].demands(p);
+				mp.addConstraint(quantity <= inst.capacity(n));
+				quantity -= inst.demand(p, n);
 				mp.addConstraint(0 <= quantity);
 				quantityLevel[n][p] = quantity;
 			}
 		}
 
+		// visitConstrs[p, v, n] limits the delivery by the visit, whose dual is the marginal cost of the capacity.
+		Arr2D<Arr<MpSolver::Constraint>> visitConstrs;
+		if (visitDuals) { visitConstrs = Arr2D<Arr<MpSolver::Constraint>>(periodNum, vehicleNum, Arr<MpSolver::Constraint>(nodeNum)); }
 		for (ID p = 0; p < periodNum; ++p) {
 			for (ID v = 0; v < vehicleNum; ++v) {
 				Expr quantity;
 				for (ID n = 0; n < nodeNum; ++n) {
 					quantity += delivery[p][v][n];
 
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
-					double quantityCoef = (n >= input.depotnum()) ? 1 : -1;
-					mp.addConstraint(quantityCoef * delivery[p][v][n] <= capacity * visits[p][n]);
+					Quantity capacity = inst.deliveryCapacity(v, n);
+					double quantityCoef = (n >= inst.depotNum()) ? 1 : -1;
+					MpSolver::Constraint constr = mp.addConstraint(quantityCoef * delivery[p][v][n] <= capacity * visits[p][n]);
+					if (visitDuals) { visitConstrs[p][v][n] = constr; }
 				}
 				// quantity matching constraint.
 				mp.addConstraint(quantity == 0);
@@ -1236,49 +1888,48 @@ namespace szx {
 		Expr holdingCost = aux.initHoldingCost;
 		for (ID n = 0; n < nodeNum; ++n) {
 			for (ID p = 0; p < periodNum; ++p) {
-				holdingCost += (nodes[n].holdingcost() * quantityLevel.at(n, p));
+				holdingCost += (inst.holdingCost(n) * quantityLevel.at(n, p));
 			}
 		}
 		mp.addObjective(holdingCost, MpSolver::OptimaOrientation::Minimize);
 
-		if (mp.optimize()) { return mp.getObjectiveValue(); }
-		return -1;
-	}
+		Price cost = mp.optimize() ? mp.getObjectiveValue() : ModelCache::Infeasible;
+		aux.modelCache.set(signature, cost);
 
-	Price Solver::callLKH(const Arr2D<ID> &visits, ID p1, ID p2) {
-		const auto &nodes(*input.mutable_nodes());
-		lkh::CoordList2D coords;
-		coords.reserve(nodeNum);
-		List<ID> nodeIdMap(nodeNum);
-		List<bool> containNode(nodeNum);
-		lkh::Tour tour;
+		if (visitDuals && (cost >= 0)) {
+			// (*visitDuals)[p, n] is the change rate of the holding cost when visiting node n at period p.
+			*visitDuals = Arr2D<Price>(periodNum, nodeNum, 0.0);
+			for (ID p = 0; p < periodNum; ++p) {
+				for (ID v = 0; v < vehicleNum; ++v) {
+					for (ID n = 0; n < nodeNum; ++n) {
+						Quantity capacity = inst.deliveryCapacity(v, n);
+						(*visitDuals)[p][n] += capacity * mp.getDualValue(visitConstrs[p][v][n]);
+					}
+				}
+			}
+		}
+		return cost;
+	}
 
+	Price Solver::callLKH(const VisitMatrix &visits, ID p1, ID p2) {
 		List<ID> periods;
 		if (p1 >= 0) { periods.push_back(p1); }
 		if (p2 >= 0) { periods.push_back(p2); }
 		if (p1 < 0 && p2 < 0) { for (ID p = 0; p < periodNum; ++p) { periods.push_back(p); } }
+		return callLKH(visits, periods);
+	}
 
-		for (ID p : periods) {
-			coords.clear();
+	Price Solver::callLKH(const VisitMatrix &visits, const List<ID> &periods) {
+		Profiler::ScopedTimer<LogSwitch::Prof::Lkh> probe(Profiler::CallLkh);
+		List<lkh::Tour> tours;
+		solveTours(tours, visits, periods);
+		for (ID i = 0; i < static_cast<ID>(periods.size()); ++i) {
+			ID p = periods[i];
+			lkh::Tour &tour(tours[i]);
 			aux.curTours[p].clear();
 			aux.tourPrices[p] = 0;
-			fill(containNode.begin(), containNode.end(), false);
-			for (ID n = 0; n < nodeNum; ++n) {
-				if (visits[p][n]) {
-					nodeIdMap[coords.size()] = n;
-					containNode[n] = true;
-					coords.push_back(lkh::Coord2D(nodes[n].x() * Precision, nodes[n].y() * Precision));
-				}
-			}
-			if (coords.size() > 2) { // repair the relaxed solution.
-				tspSolver->solve(tour, containNode, coords, [&](ID n) { return nodeIdMap[n]; });
-			}
-			else if (coords.size() == 2) { // trivial cases.
-				tour.nodes.resize(2);
-				tour.nodes[0] = nodeIdMap[0];
-				tour.nodes[1] = nodeIdMap[1];
-			}
-			else {
+			aux.staleTours[p] = false;
+			if (tour.nodes.size() < 2) {
 				aux.curTours[p] = { 0,0 };
 				continue;
 			}
@@ -1293,14 +1944,35 @@ namespace szx {
 		return tourCost;
 	}
 
-	Price Solver::callLKH4Cost(const Arr2D<ID> &visits, ID p1, ID p2) {
-		const auto &nodes(*input.mutable_nodes());
-		lkh::CoordList2D coords;
-		coords.reserve(nodeNum);
-		List<ID> nodeIdMap(nodeNum);
+	Price Solver::repairTours(const VisitMatrix &visits, ID p1, ID p2) {
 		List<bool> containNode(nodeNum);
-		lkh::Tour tour;
+		for (ID p : { p1, p2 }) {
+			if (p < 0) { continue; }
+			for (ID n = 0; n < nodeNum; ++n) { containNode[n] = visits.at(p, n); }
+			List<ID> &tour(aux.curTours[p]);
+			if (!aux.tourRepair.sync(tour, containNode)) { continue; }
+			aux.tourRepair.improve(tour);
+			aux.tourPrices[p] = aux.tourRepair.tourCost(tour);
+			aux.staleTours[p] = true;
+		}
+		Price tourCost = 0.0;
+		for (double price : aux.tourPrices) { tourCost += price; }
+		return tourCost;
+	}
+
+	Price Solver::reoptimizeTours(const VisitMatrix &visits) {
+		List<ID> stalePeriods;
+		for (ID p = 0; p < periodNum; ++p) {
+			if (aux.staleTours[p]) { stalePeriods.push_back(p); }
+		}
+		if (!stalePeriods.empty()) { return callLKH(visits, stalePeriods); }
+		Price tourCost = 0.0;
+		for (double price : aux.tourPrices) { tourCost += price; }
+		return tourCost;
+	}
 
+	Price Solver::callLKH4Cost(const VisitMatrix &visits, ID p1, ID p2) {
+		Profiler::ScopedTimer<LogSwitch::Prof::Lkh> probe(Profiler::CallLkh);
 		List<ID> periods;
 		if (p1 >= 0) { periods.push_back(p1); }
 		if (p2 >= 0) { periods.push_back(p2); }
@@ -1312,38 +1984,40 @@ namespace szx {
 			tourCost += aux.tourPrices[p];
 		}
 
-		for (ID p : periods) {
-			coords.clear();
-			fill(containNode.begin(), containNode.end(), false);
-			for (ID n = 0; n < nodeNum; ++n) {
-				if (visits[p][n]) {
-					nodeIdMap[coords.size()] = n;
-					containNode[n] = true;
-					coords.push_back(lkh::Coord2D(nodes[n].x() * Precision, nodes[n].y() * Precision));
-				}
-			}
-			if (coords.size() > 2) { // repair the relaxed solution.
-				tspSolver->solve(tour, containNode, coords, [&](ID n) { return nodeIdMap[n]; });
-			}
-			else if (coords.size() == 2) { // trivial cases.
-				tour.nodes.resize(2);
-				tour.nodes[0] = nodeIdMap[0];
-				tour.nodes[1] = nodeIdMap[1];
-			}
-			else {
-				continue;
-			}
-			tour.nodes.push_back(tour.nodes.front());
-			for (auto n = tour.nodes.begin(), m = n + 1; m != tour.nodes.end(); ++n, ++m) {
+		List<lkh::Tour> tours;
+		solveTours(tours, visits, periods);
+		for (auto tour = tours.begin(); tour != tours.end(); ++tour) {
+			if (tour->nodes.size() < 2) { continue; }
+			tour->nodes.push_back(tour->nodes.front());
+			for (auto n = tour->nodes.begin(), m = n + 1; m != tour->nodes.end(); ++n, ++m) {
 				tourCost += aux.routingCost.at(*n, *m);
 			}
 		}
 		return tourCost;
 	}
 
-	void Solver::getBestSln(Solution &sln, const Arr2D<ID> &visits) {
-		ID vehicleNum = input.vehicles_size();
-		const auto &nodes(*input.mutable_nodes());
+	void Solver::buildTspRequest(CachedTspSolver::NodeSetRequest &request) const {
+		request.coords.clear();
+		request.nodeIds.clear();
+		for (ID n = 0; n < nodeNum; ++n) {
+			if (!request.containNode[n]) { continue; }
+			request.nodeIds.push_back(n);
+			request.coords.push_back(lkh::Coord2D(inst.x(n) * Precision, inst.y(n) * Precision));
+		}
+	}
+
+	void Solver::solveTours(List<lkh::Tour> &tours, const VisitMatrix &visits, const List<ID> &periods) {
+		List<CachedTspSolver::NodeSetRequest> requests(periods.size());
+		for (ID i = 0; i < static_cast<ID>(periods.size()); ++i) {
+			requests[i].containNode.assign(nodeNum, false);
+			for (ID n = 0; n < nodeNum; ++n) { requests[i].containNode[n] = visits.at(periods[i], n); }
+			buildTspRequest(requests[i]);
+		}
+		tspSolver->solveBatch(tours, requests);
+	}
+
+	bool Solver::getBestSln(Solution &sln, const VisitMatrix &visits) {
+		ID vehicleNum = inst.vehicleNum();
 		MpSolver::Configuration mpCfg;
 		MpSolver mp(mpCfg);
 
@@ -1355,12 +2029,12 @@ namespace szx {
 		// add decision variables.
 		for (ID p = 0; p < periodNum; ++p) {
 			for (ID v = 0; v < vehicleNum; ++v) {
-				for (ID n = 0; n < input.depotnum(); ++n) {
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
+				for (ID n = 0; n < inst.depotNum(); ++n) {
+					Quantity capacity = inst.deliveryCapacity(v, n);
 					delivery[p][v][n] = mp.addVar(MpSolver::VariableType::Real, -capacity, 0);
 				}
-				for (ID n = input.depotnum(); n < nodeNum; ++n) {
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
+				for (ID n = inst.depotNum(); n < nodeNum; ++n) {
+					Quantity capacity = inst.deliveryCapacity(v, n);
 					delivery[p][v][n] = mp.addVar(MpSolver::VariableType::Real, 0, capacity);
 				}
 			}
@@ -1368,14 +2042,14 @@ namespace szx {
 
 		// add constraints.
 		for (ID n = 0; n < nodeNum; ++n) {
-			Expr quantity = nodes[n].initquantity();
+			Expr quantity = inst.initQuantity(n);
 			for (ID p = 0; p < periodNum; ++p) {
 				for (ID v = 0; v < vehicleNum; ++v) {
 					quantity += delivery[p][v][n];
 				}
 				// node capacity constraint.
-				mp.addConstraint(quantity <= nodes[n].capacity());
-				quantity -= nodes[n].demands(p);
+				mp.addConstraint(quantity <= inst.capacity(n));
+				quantity -= inst.demand(p, n);
 				mp.addConstraint(0 <= quantity);
 				quantityLevel[n][p] = quantity;
 			}
@@ -1387,8 +2061,8 @@ namespace szx {
 				for (ID n = 0; n < nodeNum; ++n) {
 					quantity += delivery[p][v][n];
 
-					Quantity capacity = min(input.vehicles(v).capacity(), nodes[n].capacity());
-					double quantityCoef = (n >= input.depotnum()) ? 1 : -1;
+					Quantity capacity = inst.deliveryCapacity(v, n);
+					double quantityCoef = (n >= inst.depotNum()) ? 1 : -1;
 					mp.addConstraint(quantityCoef * delivery[p][v][n] <= capacity * visits[p][n]);
 				}
 				// quantity matching constraint.
@@ -1400,7 +2074,7 @@ namespace szx {
 		Expr holdingCost = aux.initHoldingCost;
 		for (ID n = 0; n < nodeNum; ++n) {
 			for (ID p = 0; p < periodNum; ++p) {
-				holdingCost += (nodes[n].holdingcost() * quantityLevel.at(n, p));
+				holdingCost += (inst.holdingCost(n) * quantityLevel.at(n, p));
 			}
 		}
 		mp.addObjective(holdingCost, MpSolver::OptimaOrientation::Minimize);
@@ -1409,17 +2083,27 @@ namespace szx {
 			sln.totalCost = callLKH(visits) + mp.getObjectiveValue();
 			for (ID p = 0; p < periodNum; ++p) {
 				for (ID v = 0; v < vehicleNum; ++v) {
-					auto &route(*sln.mutable_periodroutes(p)->mutable_vehicleroutes(v));
-					route.clear_deliveries();
+					sln.clearRoute(p, v);
 					if (aux.curTours[p].size() > 2) {
 						for (auto n = aux.curTours[p].begin() + 1; n != aux.curTours[p].end(); ++n) {
-							auto &d(*route.add_deliveries());
-							d.set_node(*n);
-							d.set_quantity(lround(mp.getValue(delivery[p][v][*n])));
+							sln.addDelivery(p, v, *n, lround(mp.getValue(delivery[p][v][*n])));
 						}
 					}
 				}
 			}
+			return true;
+		}
+		return false;
+	}
+
+	void Solver::getVisits(const Solution &sln, VisitMatrix &visits) {
+		visits.reset();
+		for (ID p = 0; p < periodNum; ++p) {
+			visits[p][0] = 1;
+			for (ID v = 0; v < inst.vehicleNum(); ++v) {
+				const ID *delivs = sln.routeNodes(p, v);
+				for (ID d = 0; d < sln.routeLen(p, v); ++d) { visits[p][delivs[d]] = 1; }
+			}
 		}
 	}
 
@@ -1448,13 +2132,12 @@ namespace szx {
 			+ addNodeTourCost(p2, n1) + addNodeTourCost(p1, n2);
 	}
 
-	unsigned Solver::hash(const Arr2D<ID> &visits, double gamma) {
+	unsigned Solver::hash(const VisitMatrix &visits, double gamma) {
 		unsigned long long sum = 0;
-		for (ID p = 0; p < periodNum; ++p) {
-			for (ID n = 0; n < nodeNum; ++n) {
-				if (visits[p][n]) {
-					sum += static_cast<unsigned>(std::pow(p*nodeNum + n, gamma));
-				}
+		for (ID n = 0; n < nodeNum; ++n) {
+			for (VisitMatrix::Word ps = visits.pattern(n); ps; ps &= (ps - 1)) {
+				ID p = VisitMatrix::lowestBit(ps);
+				sum += static_cast<unsigned>(std::pow(p*nodeNum + n, gamma));
 			}
 		}
 		return sum % BitSize;
@@ -1483,7 +2166,7 @@ namespace szx {
 		return (H1[hv1] && H2[hv2] && H3[hv3]);
 	}
 
-	bool Solver::isTabu(const Arr2D<ID> &visits) {
+	bool Solver::isTabu(const VisitMatrix &visits) {
 		unsigned hv1 = hash(visits, gamma1), hv2 = hash(visits, gamma2), hv3 = hash(visits, gamma3);
 		return (H1[hv1] && H2[hv2] && H3[hv3]);
 	}
@@ -1509,7 +2192,7 @@ namespace szx {
 			hv3 += (static_cast<unsigned>(std::pow(vid1, gamma3)) - static_cast<unsigned>(std::pow(vid2, gamma3)));
 		}
 		hv1 %= BitSize, hv2 %= BitSize, hv3 %= BitSize;
-		H1[hv1] = H2[hv2] = H3[hv3] = 1;
+		H1.set(hv1); H2.set(hv2); H3.set(hv3);
 	}
 
 	// ÿִ tabu ı hashValue
@@ -1533,17 +2216,37 @@ namespace szx {
 			hashValue3 += (static_cast<unsigned>(std::pow(vid1, gamma3)) - static_cast<unsigned>(std::pow(vid2, gamma3)));
 		}
 		hashValue1 %= BitSize, hashValue2 %= BitSize, hashValue3 %= BitSize;
-		H1[hashValue1] = H2[hashValue2] = H3[hashValue3] = 1;
+		H1.set(hashValue1); H2.set(hashValue2); H3.set(hashValue3);
 	}
 
-	void Solver::execTabu(const Arr2D<ID> &visits, bool change) {
+	void Solver::execTabu(const VisitMatrix &visits, bool change) {
 		if (change) {
 			hashValue1 = hash(visits, gamma1), hashValue2 = hash(visits, gamma2), hashValue3 = hash(visits, gamma3);
-			H1[hashValue1] = H2[hashValue2] = H3[hashValue3] = 1;
+			H1.set(hashValue1); H2.set(hashValue2); H3.set(hashValue3);
 		}
 		else {
 			unsigned hv1 = hash(visits, gamma1), hv2 = hash(visits, gamma2), hv3 = hash(visits, gamma3);
-			H1[hv1] = H2[hv2] = H3[hv3] = 1;
+			H1.set(hv1); H2.set(hv2); H3.set(hv3);
+		}
+	}
+
+	bool Solver::isCheaper(const Actor &a1, const Actor &a2) {
+		return a1.totalCost < a2.totalCost;
+	}
+
+	bool Solver::isCheapEnough(const List<Actor> &heap, Price tourCost, size_t k) {
+		return (heap.size() < k) || (tourCost < heap.front().totalCost);
+	}
+
+	void Solver::keepCheapest(List<Actor> &heap, const Actor &act, size_t k) {
+		if (heap.size() < k) {
+			heap.push_back(act);
+			std::push_heap(heap.begin(), heap.end(), isCheaper);
+		}
+		else if (isCheaper(act, heap.front())) {
+			std::pop_heap(heap.begin(), heap.end(), isCheaper);
+			heap.back() = act;
+			std::push_heap(heap.begin(), heap.end(), isCheaper);
 		}
 	}
 
@@ -1561,38 +2264,20 @@ namespace szx {
 		}
 	}
 
-	void Solver::copySln(Solution &lhs, Solution &rhs) {
-		if (&lhs != &rhs) {
-			lhs.init(periodNum, input.vehicles_size());
-			lhs.totalCost = rhs.totalCost;
-			for (ID p = 0; p < periodNum; ++p) {
-				for (ID v = 0; v < input.vehicles_size(); ++v) {
-					auto &route(*lhs.mutable_periodroutes(p)->mutable_vehicleroutes(v));
-					route.clear_deliveries();
-					const auto &delivs(*rhs.mutable_periodroutes(p)->mutable_vehicleroutes(v)->mutable_deliveries());
-					for (auto n = delivs.cbegin(); n != delivs.cend(); ++n) {
-						auto &d(*route.add_deliveries());
-						d.set_node(n->node());
-						d.set_quantity(n->quantity());
-					}
-				}
-			}
-		}
-	}
-
-	void Solver::printSln(Solution &sln) {
+	void Solver::printSln(const Solution &sln) {
 		cout << "-------- print solution ---------" << endl;
 		for (ID p = 0; p < periodNum; ++p) {
 			Price routingCost = 0.0;
 			cout << "p=" << p << "\nrout: ";
-			for (ID v = 0; v < input.vehicles_size(); ++v) {
-				const auto &delivs(*sln.mutable_periodroutes(p)->mutable_vehicleroutes(v)->mutable_deliveries());
-				if (!delivs.empty()) {
-					ID s = delivs.rbegin()->node(); cout << s << "-";
-					routingCost += aux.routingCost[s][delivs.begin()->node()];
-					for (auto n = delivs.cbegin(), m = n + 1; m != delivs.cend(); ++n, ++m) {
-						routingCost += aux.routingCost[n->node()][m->node()];
-						cout << n->node() << "-";
+			for (ID v = 0; v < inst.vehicleNum(); ++v) {
+				ID len = sln.routeLen(p, v);
+				const ID *delivs = sln.routeNodes(p, v);
+				if (len > 0) {
+					ID s = delivs[len - 1]; cout << s << "-";
+					routingCost += aux.routingCost[s][delivs[0]];
+					for (ID n = 0, m = n + 1; m < len; ++n, ++m) {
+						routingCost += aux.routingCost[delivs[n]][delivs[m]];
+						cout << delivs[n] << "-";
 					}
 				}
 				cout << "\ntourCost=" << routingCost << endl;
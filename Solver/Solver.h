@@ -14,6 +14,8 @@
 #include <functional>
 #include <sstream>
 #include <thread>
+#include <mutex>
+#include <atomic>
 #include <initializer_list>
 
 #include "Common.h"
@@ -22,10 +24,22 @@
 #include "Problem.h"
 #include "MpSolver.h"
 #include "CachedTspSolver.h"
+#include "VisitMatrix.h"
+#include "InstanceView.h"
+#include "ModelCache.h"
+#include "TourRepair.h"
+#include "Profiler.h"
+#include "AsyncLog.h"
+#include "SolutionWriter.h"
+#include "SolutionChecker.h"
 
 namespace szx {
 
+	class Microbenchmark;
+
 	class Solver {
+	friend class Microbenchmark; // time the protected kernels in isolation.
+
 #pragma region Type
 	public:
 		enum ActorType { DEL, ADD, MOV, SWP, DUM };
@@ -63,6 +77,7 @@ namespace szx {
 			static String EnvironmentPathOption() { return "-env"; }
 			static String ConfigPathOption() { return "-cfg"; }
 			static String LogPathOption() { return "-log"; }
+			static String ResumePathOption() { return "-resume"; }
 
 			static String AuthorNameSwitch() { return "-name"; }
 			static String HelpSwitch() { return "-h"; }
@@ -72,7 +87,7 @@ namespace szx {
 				return "Pattern (args can be in any order):\n"
 					"  exe (-p path) (-o path) [-s int] [-t seconds] [-name]\n"
 					"      [-iter int] [-j int] [-id string] [-h]\n"
-					"      [-env path] [-cfg path] [-log path]\n"
+					"      [-env path] [-cfg path] [-log path] [-resume path]\n"
 					"Switches:\n"
 					"  -name  return the identifier of the authors.\n"
 					"  -h     print help information.\n"
@@ -87,6 +102,7 @@ namespace szx {
 					"  -env   environment file path.\n"
 					"  -cfg   configuration file path.\n"
 					"  -log   activate logging and specify log file path.\n"
+					"  -resume continue the search saved in the checkpoint file.\n"
 					"Note:\n"
 					"  0. in pattern, () is non-optional group, [] is optional group\n"
 					"     when -env option is not given.\n"
@@ -119,13 +135,27 @@ namespace szx {
 				String threadNum(std::to_string(threadNumPerWorker));
 				std::ostringstream oss;
 				oss << "alg=" << alg
-					<< ";job=" << threadNum;
+					<< ";job=" << threadNum
+					<< ";mip=" << mipThreadNum
+					<< ";win=" << windowJobNum
+					<< ";hint=" << mipHint
+					<< ";pool=" << elitePoolSize
+					<< ";cache=" << modelCacheSize
+					<< ";lkh=" << lkhInterval
+					<< ";ckpt=" << checkpointInterval;
 				return oss.str();
 			}
 
 
 			Algorithm alg = Configuration::Algorithm::Greedy; // OPTIMIZE[szx][3]: make it a list to specify a series of algorithms to be used by each threads in sequence.
 			int threadNumPerWorker = (std::min)(1, static_cast<int>(std::thread::hardware_concurrency()));
+			int mipThreadNum = 4; // thread number of each MIP solver.
+			int windowJobNum = 1; // number of period windows to be solved at the same time (1 for sequential).
+			bool mipHint = false; // also pass the incumbent routes of the window models as variable hints besides the MIP start.
+			int elitePoolSize = 0; // number of pool solutions collected from each model as restarts of the tabu search (0 to disable).
+			int modelCacheSize = ModelCache::DefaultCapacity; // max number of feasible visit patterns whose holding cost is memorized.
+			int lkhInterval = 8; // re-optimize the locally repaired tours by LKH every lkhInterval steps in the tabu search (1 for always).
+			int checkpointInterval = 60; // seconds between two checkpoints in the local search (0 to disable checkpoints).
 		};
 
 		// describe the requirements to the input and output data interface.
@@ -134,13 +164,15 @@ namespace szx {
 			static constexpr int DefaultMaxIter = (1 << 30);
 			static constexpr int DefaultJobNum = 0;
 			// preserved time for IO in the total given time.
-			static constexpr int SaveSolutionTimeInMillisecond = 1000;
+			// it only covers the final write since the best solution is kept on disk during the search.
+			static constexpr int SaveSolutionTimeInMillisecond = 200;
 
 			static constexpr Duration RapidModeTimeoutThreshold = 600 * static_cast<Duration>(Timer::MillisecondsPerSecond);
 
 			static String DefaultInstanceDir() { return "Instance/"; }
 			static String DefaultSolutionDir() { return "Solution/"; }
 			static String DefaultVisualizationDir() { return "Visualization/"; }
+			static String DefaultTspCacheDir() { return "TspCache/"; }
 			static String DefaultEnvPath() { return "env.csv"; }
 			static String DefaultCfgPath() { return "cfg.csv"; }
 			static String DefaultLogPath() { return "log.csv"; }
@@ -162,6 +194,9 @@ namespace szx {
 			void calibrate(); // adjust job number and timeout to fit the platform.
 
 			String solutionPathWithTime() const { return slnPath + "." + localTime; }
+			String checkpointPath() const { return slnPath + ".ckpt"; }
+			// empty if the TSP cache is not kept on disk.
+			String tspCachePath() const { return isTspCachePersistent ? (DefaultTspCacheDir() + friendlyInstName() + ".csv") : String(); }
 
 			String visualizPath() const { return DefaultVisualizationDir() + friendlyInstName() + "." + localTime + ".html"; }
 			template<typename T>
@@ -169,7 +204,8 @@ namespace szx {
 			String friendlyInstName() const { // friendly to file system (without special char).
 				auto pos = instPath.find_last_of('/');
 				String filename = (pos == String::npos) ? instPath : instPath.substr(pos + 1);
-				return filename.substr(0, filename.length() - 5); // drop ".json".
+				size_t extLen = pb::isBinaryPath(filename) ? FileExtension::protobuf().length() : FileExtension::json().length();
+				return filename.substr(0, filename.length() - extLen); // drop ".json" or ".pb".
 			}
 			String friendlyLocalTime() const { // friendly to human.
 				return localTime.substr(0, 4) + "-" + localTime.substr(4, 2) + "-" + localTime.substr(6, 2)
@@ -189,23 +225,184 @@ namespace szx {
 			String rid; // the id of each run.
 			String cfgPath;
 			String logPath;
+			String resumePath; // continue the search saved in this checkpoint if it is not empty.
+			bool isTspCachePersistent = true; // load the tours solved by the previous runs of the instance and save them for the later ones.
 
 			// auto-generated data.
 			String localTime;
 		};
 
-		struct Solution : public Problem::Output { // delivery plan.
+		// delivery plan in flat arrays which are cheap to copy and move.
+		// it is only converted into Problem::Output when the final output is written.
+		struct Solution {
 			Solution(Solver *pSolver = nullptr) : solver(pSolver) {}
-			void init(ID periodNum, ID vehicleNum, Price initCost = 0) {
+			void init(ID periodNumber, ID vehicleNumber, ID nodeNumber, Price initCost = 0) {
 				totalCost = initCost;
-				for (ID p = 0; p < periodNum; ++p) {
-					auto &periodRoute(*add_periodroutes());
-					for (ID v = 0; v < vehicleNum; ++v) {
-						periodRoute.add_vehicleroutes();
-					}
-				}
+				periodNum = periodNumber;
+				vehicleNum = vehicleNumber;
+				// assign new arrays since Arr::init() does nothing on allocated ones.
+				routeLens = Arr<ID>(periodNum * vehicleNum, 0);
+				nodes = Arr2D<ID>(periodNum * vehicleNum, nodeNumber);
+				quantities = Arr2D<Quantity>(periodNum * vehicleNum, nodeNumber);
+			}
+
+			// the route of vehicle v at period p visits nodes[r][i] with quantities[r][i] for i < routeLens[r]
+			// where r = routeIndex(p, v), and the depot is the last one.
+			ID routeIndex(ID p, ID v) const { return p * vehicleNum + v; }
+			ID routeLen(ID p, ID v) const { return routeLens[routeIndex(p, v)]; }
+			const ID* routeNodes(ID p, ID v) const { return nodes[routeIndex(p, v)]; }
+			Quantity* routeQuantities(ID p, ID v) { return quantities[routeIndex(p, v)]; }
+			const Quantity* routeQuantities(ID p, ID v) const { return quantities[routeIndex(p, v)]; }
+
+			void clearRoute(ID p, ID v) { routeLens[routeIndex(p, v)] = 0; }
+			void addDelivery(ID p, ID v, ID node, Quantity quantity) {
+				ID r = routeIndex(p, v);
+				ID &len(routeLens[r]);
+				nodes[r][len] = node;
+				quantities[r][len] = quantity;
+				++len;
 			}
+
+			void toOutput(Problem::Output &output) const;
+
 			Solver *solver;
+			Price totalCost = 0;
+			ID periodNum = 0;
+			ID vehicleNum = 0;
+			Arr<ID> routeLens;
+			Arr2D<ID> nodes;
+			Arr2D<Quantity> quantities;
+		};
+
+		// a visit pattern collected from the solution pool of a model.
+		struct Elite {
+			VisitMatrix visits;
+			Price cost; // objective value in the model where it was found.
+			unsigned signature[3]; // hash values in the tabu tables.
+		};
+
+		// an update of the best solution and the procedure that finds it.
+		struct Improvement {
+			enum Source { Model, Window, TabuSearch, Disturb, Elite, Checkpoint, SourceNum };
+
+			static String sourceName(Source source) {
+				static const String names[SourceNum] = { "model", "window", "ts", "disturb", "elite", "checkpoint" };
+				return names[source];
+			}
+
+			double time; // elapsed seconds since the solver starts.
+			Price cost;
+			Source source;
+		};
+
+		// split the time budget of execSearch() among the search phases.
+		// each phase takes its share from the time that is actually left when it starts, where the prior share of every
+		// phase is scaled by its expected gain per second, so the time moves to the phases that keep improving the incumbent.
+		// the expected rate of a phase is measured once it has run for a while (in this run or before a resume),
+		// and is taken from the whole search before that. the budget of the running phase is revised after each record().
+		struct Scheduler {
+			enum Phase { Model, Window3, Window2, Local, PhaseNum };
+
+			// stop a model when it has not improved the incumbent for max(MinStallSecond, StallRatio * timeLimit).
+			static constexpr double MinStallSecond = 2;
+			static constexpr double StallRatio = 0.25;
+			// a phase keeps at least MinRateRatio of its prior weight even if it has not improved anything.
+			static constexpr double MinRateRatio = 0.25;
+			// the gain rate of a phase is trusted after it has run for MinMeasureSecond.
+			static constexpr double MinMeasureSecond = 1;
+
+			static double share(Phase phase) {
+				static constexpr double shares[PhaseNum] = { 0.2, 0.3, 0.2, 0.3 };
+				return shares[phase];
+			}
+			static double stallSecond(double timeLimitInSecond) { return (std::max)(MinStallSecond, StallRatio * timeLimitInSecond); }
+			static String phaseName(Phase phase) {
+				static const String names[PhaseNum] = { "model", "window3", "window2", "local" };
+				return names[phase];
+			}
+
+			Scheduler() : phaseTimer(Timer::Millisecond(0)) {}
+
+			void enter(Phase phase, double restSecond) {
+				spentSeconds[curPhase] += elapsedSeconds();
+				curPhase = phase;
+				restSecondOnEnter = (std::max)(restSecond, 0.0);
+				phaseTimer = Timer(Timer::Millisecond(0));
+				allot();
+			}
+			void record(Price prevCost, Price curCost) {
+				if (curCost < prevCost) { gains[curPhase] += prevCost - curCost; }
+				allot();
+			}
+
+			// expected gain per second of the phase.
+			double expectedRate(Phase phase) const {
+				double spent = spentSecondsIn(phase);
+				if (spent >= MinMeasureSecond) { return gains[phase] / spent; }
+				double totalGain = 0, totalSpent = 0;
+				for (int p = 0; p < PhaseNum; ++p) {
+					totalGain += gains[p];
+					totalSpent += spentSecondsIn(static_cast<Phase>(p));
+				}
+				return (totalSpent >= MinMeasureSecond) ? (totalGain / totalSpent) : 0;
+			}
+			// the ratio of the time left on entering the current phase that it may take.
+			double allotRatio() const {
+				double maxRate = 0;
+				for (int p = curPhase; p < PhaseNum; ++p) { maxRate = (std::max)(maxRate, expectedRate(static_cast<Phase>(p))); }
+				double weight = 0, restWeight = 0;
+				for (int p = curPhase; p < PhaseNum; ++p) {
+					Phase phase = static_cast<Phase>(p);
+					double w = share(phase) * ((maxRate > 0) ? (std::max)(expectedRate(phase) / maxRate, MinRateRatio) : 1);
+					if (p == curPhase) { weight = w; }
+					restWeight += w;
+				}
+				return weight / restWeight;
+			}
+			void allot() {
+				budget = restSecondOnEnter * allotRatio();
+				phaseTimer = Timer(Timer::toMillisecond(budget), phaseTimer.getStartTime());
+			}
+
+			bool isTimeOut() const { return phaseTimer.isTimeOut(); }
+			double restSeconds() const { return (std::max)(phaseTimer.restSeconds(), 0.0); }
+			double elapsedSeconds() const { return phaseTimer.elapsedSeconds(); }
+			double spentSecondsIn(Phase phase) const { return spentSeconds[phase] + ((phase == curPhase) ? elapsedSeconds() : 0); }
+
+			Phase curPhase = Model;
+			double budget = 0;
+			double restSecondOnEnter = 0;
+			Timer phaseTimer;
+			Price gains[PhaseNum] = { 0 }; // accumulated improvement of the incumbent, including the ones before a resume.
+			double spentSeconds[PhaseNum] = { 0 }; // accumulated time of the finished phases, including the ones before a resume.
+		};
+
+		// tabu table which also lists its latest set bits, so that it can be saved without scanning all bits.
+		// the list is bounded to keep the memory and the checkpoint size constant, so a resumed search forgets the older tabu solutions.
+		struct TabuTable {
+			static constexpr size_t MaxListedBitNum = (1 << 18);
+
+			void init(size_t bitNum) {
+				bits.assign(bitNum, false);
+				setBits.clear();
+			}
+
+			bool operator[](size_t i) const { return bits[i]; }
+			void set(size_t i) {
+				if (bits[i]) { return; }
+				bits[i] = true;
+				// drop the older half at once so that the list is trimmed in amortized constant time.
+				if (setBits.size() >= 2 * MaxListedBitNum) { setBits.erase(setBits.begin(), setBits.end() - MaxListedBitNum); }
+				setBits.push_back(static_cast<unsigned>(i));
+			}
+
+			// the first of the latest MaxListedBitNum set bits.
+			List<unsigned>::const_iterator listedBegin() const {
+				return (setBits.size() > MaxListedBitNum) ? (setBits.end() - MaxListedBitNum) : setBits.begin();
+			}
+
+			List<bool> bits;
+			List<unsigned> setBits; // in the order of being set.
 		};
 #pragma endregion Type
 
@@ -215,6 +412,8 @@ namespace szx {
 		static constexpr unsigned BitSize = 10e8;
 		static constexpr double gamma1 = 1.8, gamma2 = 2.4, gamma3 = 3.0;
 		static constexpr int alpha = 25;
+		static constexpr int MaxEliteNum = 32;
+		static constexpr int CheckpointVersion = 3; // increase it when the format of the checkpoint changes.
 
 #pragma endregion Constant
 
@@ -222,7 +421,7 @@ namespace szx {
 	public:
 		Solver(const Problem::Input &inputData, const Environment &environment, const Configuration &config)
 			: input(inputData), env(environment), cfg(config), rand(environment.randSeed),
-			timer(std::chrono::milliseconds(environment.msTimeout)), iteration(1) {}
+			timer(std::chrono::milliseconds(environment.msTimeout)), isResumed(false), iteration(1) {}
 #pragma endregion Constructor
 
 #pragma region Method
@@ -230,41 +429,86 @@ namespace szx {
 		bool solve(); // return true if exit normally. solve by multiple workers together.
 		bool check(double &obj) const;
 		void record() const; // save running log.
+		// stop the search at the next checkpoint. it is safe to be called in a signal handler.
+		static void requestTermination(int) { isTerminationRequested = true; }
+		void initSubmission(pb::Submission &submission, Price obj, double durationInSecond) const;
 
 	protected:
 		void init();
 		bool optimize(Solution &sln, ID workerId = 0); // optimize by a single worker.
+		// the tours are not loaded from or saved to file if `cachePath` is empty.
+		void initTspSolver(const String &cachePath = "");
 
-		void iteratedModel(Solution &sln);
+		void iteratedModel(Solution &sln, double timeInSec);
 		void initialSln(Solution &sln);
-		Price callLKH(const Arr2D<ID> &visits, ID p1 = -1, ID p2 = -1);
-		Price callLKH4Cost(const Arr2D<ID> &visits, ID p1 = -1, ID p2 = -1);
-		Price callModel(Arr2D<int> &visits);
+		// update bestSlnTime and append the improvement to the anytime profile if it beats all the recorded ones.
+		void recordImprovement(Price cost, Improvement::Source source);
+		Timer::TimePoint lastImprovementTime();
+		// hand the solution to slnWriter if it is better than the written ones.
+		void streamSln(const Solution &sln);
+		// find the visits implied by the stock-out and capacity limits of each customer.
+		void fixVisits();
+		// the edge (n, m) at period p is not excluded by the forbidden visits.
+		bool isVisitable(ID p, ID n, ID m) const;
+		// a visit can be added at (apid, anid) and removed at (dpid, dnid).
+		bool isMovable(ID apid, ID anid, ID dpid, ID dnid) const;
+		Price callLKH(const VisitMatrix &visits, ID p1 = -1, ID p2 = -1);
+		// update the tours of all `periods` by LKH in one batch and return the total tour cost.
+		Price callLKH(const VisitMatrix &visits, const List<ID> &periods);
+		Price callLKH4Cost(const VisitMatrix &visits, ID p1 = -1, ID p2 = -1);
+		// collect the nodes in `request.containNode` with their coordinates.
+		void buildTspRequest(CachedTspSolver::NodeSetRequest &request) const;
+		// solve the TSP of each period in `periods` concurrently.
+		void solveTours(List<lkh::Tour> &tours, const VisitMatrix &visits, const List<ID> &periods);
+		// update the tours of period p1 and p2 by insertion, removal and local search instead of LKH.
+		Price repairTours(const VisitMatrix &visits, ID p1, ID p2);
+		// re-optimize the tours modified by repairTours() with LKH.
+		Price reoptimizeTours(const VisitMatrix &visits);
+		// also retrieve the duals of the visit constraints if `visitDuals` is not null.
+		Price callModel(const VisitMatrix &visits, Arr2D<Price> *visitDuals = nullptr);
 		void execSearch(Solution &sln);
-		void getBestSln(Solution &sln, const Arr2D<ID> &visits);
-		void getNeighWithModel(Solution &sln, const Arr2D<ID> &visits, const List<ID> &pl, double timeInSec);
-
-		int buildMixNeigh(Arr2D<ID> &visits, Price minCost = Problem::MaxCost);
-		bool mixTabuSearch(Arr2D<ID> &visits, Price initCost);
-		void disturb(Arr2D<ID> &visits);
-		void mixFinalSearch();
+		bool isStopping() const { return timer.isTimeOut() || isTerminationRequested; }
+		// save the search state which is resumed at `resumePhase` if the checkpoint interval has passed or `force` is true.
+		void checkpoint(const Scheduler &scheduler, Scheduler::Phase resumePhase, bool force = true);
+		bool saveCheckpoint(const String &path, const Scheduler &scheduler, Scheduler::Phase resumePhase) const;
+		// restore the search state and set `scheduler.curPhase` to the phase to resume.
+		bool loadCheckpoint(const String &path, Scheduler &scheduler);
+		bool getBestSln(Solution &sln, const VisitMatrix &visits);
+		void getVisits(const Solution &sln, VisitMatrix &visits);
+		void getNeighWithModel(Solution &sln, const VisitMatrix &visits, const List<ID> &pl, double timeInSec);
+		void getNeighWithModels(Solution &sln, const List<List<ID>> &windows, double timeInSec);
+		bool solveWindow(Solution &sln, const VisitMatrix &visits, const List<ID> &pl, double timeInSec, int threadNum, double tourcostFactor);
+		void harvestPool(MpSolver &mp, Arr2D<Arr2D<Dvar>> &x, const List<ID> &pl, const VisitMatrix &visits);
+		void addElite(const VisitMatrix &visits, Price cost);
+		void restartFromElites();
+
+		int buildMixNeigh(VisitMatrix &visits, Price minCost = Problem::MaxCost);
+		// lower bound on the holding cost after applying `act` to the visits whose holding cost is `baseCost`.
+		Price modelCostBound(const Actor &act, Price baseCost) const;
+		bool mixTabuSearch(VisitMatrix &visits, Price initCost);
+		void disturb(VisitMatrix &visits);
+		void mixFinalSearch(const Scheduler &scheduler);
 
 		Price addNodeTourCost(ID p, ID n);
 		Price delNodeTourCost(ID p, ID n);
 		Price movNodeTourCost(ID apid, ID anid, ID dpid, ID dnid);
 		Price swpNodeTourCost(ID p1, ID n1, ID p2, ID n2);
 
-		unsigned hash(const Arr2D<ID> &visits, double gamma);
+		unsigned hash(const VisitMatrix &visits, double gamma);
 		bool isTabu(unsigned long hv1, unsigned long hv2, unsigned long hv3, const Actor& act);
-		bool isTabu(const Arr2D<ID> &visits);
+		bool isTabu(const VisitMatrix &visits);
 		void execTabu(unsigned long hv1, unsigned long hv2, unsigned long hv3, const Actor& act);
 		void execTabu(const Actor& act);
-		void execTabu(const Arr2D<ID> &visits, bool change = false);
+		void execTabu(const VisitMatrix &visits, bool change = false);
 		template<typename T>
 		void sampling(const List<T> &pool, List<T> &res, ID K);
 
-		void copySln(Solution &lhs, Solution &rhs);
-		void printSln(Solution &sln);
+		// bounded max-heaps on the total cost for selecting the k cheapest actors.
+		static bool isCheaper(const Actor &a1, const Actor &a2);
+		static bool isCheapEnough(const List<Actor> &heap, Price tourCost, size_t k);
+		static void keepCheapest(List<Actor> &heap, const Actor &act, size_t k);
+
+		void printSln(const Solution &sln);
 		void printInfo();
 
 #pragma endregion Method
@@ -273,19 +517,31 @@ namespace szx {
 	public:
 		Problem::Input input;
 		Problem::Output output;
+		InstanceView inst; // flat copy of `input` which is read by the search instead of the protobuf accessors.
 		CachedTspSolver *tspSolver;
 
 		ID periodNum, nodeNum;
-		List<bool> H1, H2, H3;
+		TabuTable H1, H2, H3;
 		unsigned hashValue1, hashValue2, hashValue3;
 
 		struct {
 			Arr2D<Price> routingCost;
 			Price initHoldingCost, bestCost;
-			Arr2D<ID> bestVisits, curVisits;
+			VisitMatrix bestVisits, curVisits;
+			VisitMatrix forcedVisits; // customers that run out of stock without the visit.
+			VisitMatrix forbiddenVisits; // customers that have no room for any delivery.
 			Arr<Price> tourPrices;
+			TourRepair tourRepair;
+			List<bool> staleTours; // staleTours[p] is true if the tour at period p has not been optimized by LKH.
 			Arr<List<ID>> curTours;	// ǰ·ɣÿθʷʱµǰ·
 			List<Actor> mixNeigh, smpres;
+			List<Actor> delNeigh, movNeigh, swpNeigh; // reused by buildMixNeigh() to avoid reallocation.
+			List<Elite> elites; // diverse restarts for the tabu search.
+			std::mutex eliteMutex; // the window models may add elites concurrently.
+			ModelCache modelCache; // holding cost of the evaluated visit patterns.
+			Arr2D<Price> visitDuals; // marginal holding cost of each visit under the current visits in buildMixNeigh().
+			long long screenedNeighNum; // number of neighbors checked by the dual bound.
+			long long prunedNeighNum; // number of neighbors skipped by the dual bound.
 		} aux;
 
 		Environment env;
@@ -293,6 +549,15 @@ namespace szx {
 		Random rand; // all random number in Solver must be generated by this.
 		Timer timer; // the solve() should return before it is timeout.
 		Timer::TimePoint bestSlnTime;
+		List<Improvement> improvements; // in increasing order of time and decreasing order of cost.
+		std::mutex improvementMutex; // guard `improvements` and `bestSlnTime`, which are updated by all workers.
+		Profiler profiler; // calls and elapsed time of the hot spots.
+		SolutionWriter slnWriter; // keep the best solution in env.slnPath during the search.
+		static std::atomic<bool> isTerminationRequested; // set by SIGTERM or SIGINT.
+		Timer::TimePoint lastCheckpointTime;
+		std::mutex checkpointMutex; // the workers share the search state and the checkpoint file.
+		Scheduler resumedScheduler; // the phase to resume and the statistics of the phases restored from env.resumePath.
+		bool isResumed;
 		Iteration iteration;
 #pragma endregion Field
 	}; // Solver 
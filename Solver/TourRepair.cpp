@@ -0,0 +1,257 @@
+#include "TourRepair.h"
+
+#include <algorithm>
+
+
+using namespace std;
+
+
+namespace szx {
+
+void TourRepair::init(const Arr2D<Price> &distMat, ID neighborNum) {
+    distances = &distMat;
+    ID nodeNum = distMat.size1();
+    ID k = (max)(0, (min)(neighborNum, nodeNum - 1));
+
+    neighbors = Arr2D<ID>(nodeNum, k);
+    List<ID> candidates;
+    candidates.reserve(nodeNum);
+    for (ID n = 0; n < nodeNum; ++n) {
+        candidates.clear();
+        for (ID m = 0; m < nodeNum; ++m) {
+            if (m != n) { candidates.push_back(m); }
+        }
+        partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(), [&](ID m1, ID m2) {
+            return dist(n, m1) < dist(n, m2);
+        });
+        copy(candidates.begin(), candidates.begin() + k, neighbors.begin(n));
+    }
+
+    pos = Arr<ID>(nodeNum, -1);
+    isActive = Arr<bool>(nodeNum, false);
+    cycle.reserve(nodeNum);
+    activeNodes.reserve(nodeNum);
+}
+
+Price TourRepair::tourCost(const Tour &tour) const {
+    Price cost = 0;
+    for (auto n = tour.begin(), m = n + 1; (n != tour.end()) && (m != tour.end()); ++n, ++m) {
+        cost += dist(*n, *m);
+    }
+    return cost;
+}
+
+void TourRepair::insert(Tour &tour, ID node) const {
+    if (tour.empty()) { tour = { node, node }; return; }
+
+    // cheapest insertion.
+    ID bestPos = 1;
+    Price minDelta = dist(tour[0], node) + dist(node, tour[1]) - dist(tour[0], tour[1]);
+    for (ID i = 1; i + 1 < static_cast<ID>(tour.size()); ++i) {
+        Price delta = dist(tour[i], node) + dist(node, tour[i + 1]) - dist(tour[i], tour[i + 1]);
+        if (delta < minDelta) {
+            minDelta = delta;
+            bestPos = i + 1;
+        }
+    }
+    tour.insert(tour.begin() + bestPos, node);
+}
+
+void TourRepair::remove(Tour &tour, ID node) const {
+    if (tour.size() <= 2) {
+        if (!tour.empty() && (tour.front() == node)) { tour.clear(); }
+        return;
+    }
+    if (tour.front() == node) { // move the start of the closed tour to the next node.
+        tour.erase(tour.begin());
+        tour.back() = tour.front();
+        return;
+    }
+    auto n = find(tour.begin(), tour.end(), node);
+    if (n != tour.end()) { tour.erase(n); }
+}
+
+bool TourRepair::sync(Tour &tour, const List<bool> &containNode) const {
+    List<bool> inTour(containNode.size(), false);
+    List<ID> absentNodes;
+    for (auto n = tour.begin(); n != tour.end(); ++n) {
+        if (inTour[*n]) { continue; } // the last node is the same as the first one.
+        inTour[*n] = true;
+        if (!containNode[*n]) { absentNodes.push_back(*n); }
+    }
+
+    bool changed = !absentNodes.empty();
+    for (ID n : absentNodes) { remove(tour, n); }
+    for (ID n = 0; n < static_cast<ID>(containNode.size()); ++n) {
+        if (containNode[n] && !inTour[n]) {
+            insert(tour, n);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+int TourRepair::improve(Tour &tour, int maxMoveNum) {
+    if (tour.size() <= 4) { return 0; } // any tour on 3 nodes is optimal.
+
+    ID start = tour.front();
+    cycle.assign(tour.begin(), tour.end() - 1);
+    for (ID i = 0; i < static_cast<ID>(cycle.size()); ++i) {
+        pos[cycle[i]] = i;
+        activate(cycle[i]);
+    }
+
+    int moveNum = 0;
+    while (!activeNodes.empty() && (moveNum < maxMoveNum)) {
+        ID n = activeNodes.back();
+        activeNodes.pop_back();
+        isActive[n] = false;
+        if (improve2Opt(n) || improveOrOpt(n)) {
+            ++moveNum;
+            activate(n);
+        }
+    }
+
+    for (ID n : activeNodes) { isActive[n] = false; }
+    activeNodes.clear();
+
+    // restore the closed form starting from the same node.
+    rotate(cycle.begin(), cycle.begin() + pos[start], cycle.end());
+    for (ID n : cycle) { pos[n] = -1; }
+    tour.assign(cycle.begin(), cycle.end());
+    tour.push_back(start);
+    return moveNum;
+}
+
+void TourRepair::reverse(ID i, ID j) {
+    ID k = static_cast<ID>(cycle.size());
+    ID len = ((j - i + k) % k) + 1;
+    for (ID s = 0; s < len / 2; ++s) {
+        swap(cycle[i], cycle[j]);
+        pos[cycle[i]] = i;
+        pos[cycle[j]] = j;
+        i = succ(i);
+        j = pred(j);
+    }
+}
+
+void TourRepair::moveSegment(ID i, ID segLen, ID x, bool reversed) {
+    ID k = static_cast<ID>(cycle.size());
+    ID segment[MaxSegmentLen];
+    for (ID s = 0; s < segLen; ++s) { segment[s] = cycle[(i + s) % k]; }
+
+    // shift the shorter path between the segment and the edge (x, succ(x)) over the segment.
+    ID j = (i + segLen - 1) % k;
+    ID afterLen = (pos[x] - j + k) % k; // number of nodes from succ(j) to x.
+    ID beforeLen = k - segLen - afterLen; // number of nodes from succ(x) to pred(i).
+    ID first; // the position of the first node of the segment after the move.
+    if (afterLen <= beforeLen) {
+        for (ID s = 0; s < afterLen; ++s) {
+            ID to = (i + s) % k;
+            cycle[to] = cycle[(to + segLen) % k];
+            pos[cycle[to]] = to;
+        }
+        first = (i + afterLen) % k;
+    } else {
+        first = succ(pos[x]);
+        for (ID s = beforeLen - 1; s >= 0; --s) {
+            ID to = (first + segLen + s) % k;
+            cycle[to] = cycle[(first + s) % k];
+            pos[cycle[to]] = to;
+        }
+    }
+
+    for (ID s = 0; s < segLen; ++s) {
+        ID to = (first + s) % k;
+        cycle[to] = segment[reversed ? (segLen - 1 - s) : s];
+        pos[cycle[to]] = to;
+    }
+}
+
+void TourRepair::activate(ID node) {
+    if (isActive[node]) { return; }
+    isActive[node] = true;
+    activeNodes.push_back(node);
+}
+
+bool TourRepair::improve2Opt(ID a) {
+    ID i = pos[a];
+
+    // replace (a, b) and (c, d) by (a, c) and (b, d) where b and d are the successors.
+    ID b = cycle[succ(i)];
+    Price dab = dist(a, b);
+    for (ID k = 0; k < neighbors.size2(); ++k) {
+        ID c = neighbors[a][k];
+        Price dac = dist(a, c);
+        if (dac >= dab) { break; }
+        ID j = pos[c];
+        if (j < 0) { continue; }
+        ID d = cycle[succ(j)];
+        if ((c == b) || (d == a)) { continue; }
+        if (Math::strongLess(dac + dist(b, d), dab + dist(c, d))) {
+            reverse(succ(i), j); // the path from b to c.
+            activate(b); activate(c); activate(d);
+            return true;
+        }
+    }
+
+    // replace (p, a) and (q, c) by (a, c) and (p, q) where p and q are the predecessors.
+    ID p = cycle[pred(i)];
+    Price dpa = dist(p, a);
+    for (ID k = 0; k < neighbors.size2(); ++k) {
+        ID c = neighbors[a][k];
+        Price dac = dist(a, c);
+        if (dac >= dpa) { break; }
+        ID j = pos[c];
+        if (j < 0) { continue; }
+        ID q = cycle[pred(j)];
+        if ((c == p) || (q == a)) { continue; }
+        if (Math::strongLess(dac + dist(p, q), dpa + dist(q, c))) {
+            reverse(i, pred(j)); // the path from a to q.
+            activate(p); activate(q); activate(c);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TourRepair::improveOrOpt(ID a) {
+    ID k = static_cast<ID>(cycle.size());
+    ID i = pos[a];
+
+    // move the segment of 1 to MaxSegmentLen nodes starting from a to another edge (c, d).
+    for (ID segLen = 1; (segLen <= MaxSegmentLen) && (segLen + 3 <= k); ++segLen) {
+        ID j = (i + segLen - 1) % k;
+        ID s1 = a, s2 = cycle[j];
+        ID p = cycle[pred(i)], nx = cycle[succ(j)];
+        Price removeGain = dist(p, s1) + dist(s2, nx) - dist(p, nx);
+        if (!Math::strongLess(0, removeGain)) { continue; }
+
+        auto inSegment = [&](ID n) { return ((pos[n] - i + k) % k) < segLen; };
+        for (ID e : { s1, s2 }) {
+            if ((e == s2) && (segLen == 1)) { break; }
+            ID o = (e == s1) ? s2 : s1; // the other end of the segment.
+            for (ID t = 0; t < neighbors.size2(); ++t) {
+                ID c = neighbors[e][t];
+                if (dist(e, c) >= removeGain) { break; }
+                if ((pos[c] < 0) || inSegment(c)) { continue; }
+                for (ID d : { cycle[succ(pos[c])], cycle[pred(pos[c])] }) {
+                    if (inSegment(d)) { continue; }
+                    // connect e to c and o to d.
+                    if (!Math::strongLess(dist(c, e) + dist(o, d) - dist(c, d), removeGain)) { continue; }
+
+                    // c -> e ... o -> d or d -> o ... e -> c.
+                    bool isForward = (cycle[succ(pos[c])] == d);
+                    moveSegment(i, segLen, isForward ? c : d, isForward == (e == s2));
+                    activate(p); activate(nx); activate(c); activate(d); activate(o);
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+}
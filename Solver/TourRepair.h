@@ -0,0 +1,74 @@
+////////////////////////////////
+/// usage : 1.	repair a closed tour after inserting or removing a few nodes by cheapest insertion
+///         	and a bounded 2-opt/Or-opt local search on neighbor lists with don't-look bits.
+///
+/// note  : 1.	a tour is a node list whose first node and last node are the same, e.g., { 0, 3, 5, 0 }.
+///         2.	the result is not as good as the LKH one, so it should be re-optimized by LKH periodically.
+////////////////////////////////
+
+#ifndef SMART_SZX_INVENTORY_ROUTING_TOUR_REPAIR_H
+#define SMART_SZX_INVENTORY_ROUTING_TOUR_REPAIR_H
+
+
+#include "Config.h"
+
+#include "Common.h"
+#include "Utility.h"
+
+
+namespace szx {
+
+class TourRepair {
+public:
+    using Tour = List<ID>;
+
+
+    static constexpr ID DefaultNeighborNum = 10;
+    static constexpr int DefaultMaxMoveNum = 1024;
+    static constexpr ID MaxSegmentLen = 3; // max number of nodes moved by an Or-opt move.
+
+
+    TourRepair() : distances(nullptr) {}
+
+    // `distMat` should outlive the repairer.
+    void init(const Arr2D<Price> &distMat, ID neighborNum = DefaultNeighborNum);
+
+    Price tourCost(const Tour &tour) const;
+
+    void insert(Tour &tour, ID node) const;
+    void remove(Tour &tour, ID node) const;
+    // make the tour contain exactly the nodes whose `containNode` is true.
+    // return false if nothing changed.
+    bool sync(Tour &tour, const List<bool> &containNode) const;
+    // return the number of applied moves.
+    int improve(Tour &tour, int maxMoveNum = DefaultMaxMoveNum);
+
+protected:
+    Price dist(ID n, ID m) const { return distances->at(n, m); }
+
+    ID succ(ID i) const { return (i + 1 < static_cast<ID>(cycle.size())) ? (i + 1) : 0; }
+    ID pred(ID i) const { return (i > 0) ? (i - 1) : (static_cast<ID>(cycle.size()) - 1); }
+    // reverse the path from position i to position j in the direction of the cycle.
+    void reverse(ID i, ID j);
+    // move the segLen nodes from position i to the edge from node x to its successor, and reverse them if required.
+    void moveSegment(ID i, ID segLen, ID x, bool reversed);
+    void activate(ID node);
+
+    bool improve2Opt(ID node);
+    bool improveOrOpt(ID node);
+
+
+    const Arr2D<Price> *distances;
+    Arr2D<ID> neighbors; // neighbors[n] are the nearest nodes of node n in increasing order of distance.
+
+    // buffers of improve().
+    List<ID> cycle; // the open form of the tour.
+    Arr<ID> pos; // pos[n] is the index of node n in the cycle or -1 if it is absent.
+    List<ID> activeNodes; // nodes whose don't-look bits are cleared.
+    Arr<bool> isActive;
+};
+
+}
+
+
+#endif // SMART_SZX_INVENTORY_ROUTING_TOUR_REPAIR_H
@@ -1,10 +1,13 @@
 #include "Utility.h"
 
+#include <cstdio>
+
 #if _OS_MS_WINDOWS
 #include <Windows.h>
 #include <Psapi.h>
 #else
-// EXTEND[szx][9]: get memory usage on *nix.
+#include <sys/resource.h>
+#include <unistd.h>
 #endif // _OS_MS_WINDOWS
 
 
@@ -13,6 +16,14 @@ using namespace std;
 
 namespace szx {
 
+bool System::replaceFile(const string &srcPath, const string &dstPath) {
+    #if _OS_MS_WINDOWS
+    return MoveFileExA(srcPath.c_str(), dstPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    #else
+    return rename(srcPath.c_str(), dstPath.c_str()) == 0;
+    #endif // _OS_MS_WINDOWS
+}
+
 System::MemoryUsage System::memoryUsage() {
     MemoryUsage mu = { 0, 0 };
 
@@ -25,7 +36,17 @@ System::MemoryUsage System::memoryUsage() {
     }
     CloseHandle(hProcess);
     #else
-
+    // the total program size and the resident set size in pages.
+    long long pageNum = 0, residentPageNum = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm != nullptr) {
+        if (fscanf(statm, "%lld %lld", &pageNum, &residentPageNum) == 2) {
+            long long pageSize = sysconf(_SC_PAGESIZE);
+            mu.physicalMemory.size = residentPageNum * pageSize;
+            mu.virtualMemory.size = pageNum * pageSize;
+        }
+        fclose(statm);
+    }
     #endif // _OS_MS_WINDOWS
 
     return mu;
@@ -43,7 +64,14 @@ System::MemoryUsage System::peakMemoryUsage() {
     }
     CloseHandle(hProcess);
     #else
-
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        #if __APPLE__
+        mu.physicalMemory.size = usage.ru_maxrss; // in bytes.
+        #else
+        mu.physicalMemory.size = usage.ru_maxrss * MemorySize::Base; // in kilobytes.
+        #endif // __APPLE__
+    }
     #endif // _OS_MS_WINDOWS
 
     return mu;
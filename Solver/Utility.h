@@ -691,6 +691,9 @@ public:
         exec(Cmd::Mkdir() + quote(dir) + Cmd::RedirectStderr() + Cmd::NullDev());
     }
 
+    // rename `srcPath` to `dstPath` in a single step, so that `dstPath` is either the old or the new file.
+    static bool replaceFile(const std::string &srcPath, const std::string &dstPath);
+
     struct MemorySize {
         using Unit = long long;
 
@@ -0,0 +1,149 @@
+////////////////////////////////
+/// usage : 1.	bit-packed visit matrix where the period pattern of each node is a single machine word.
+///
+/// note  : 1.	the period number should not exceed 64.
+///         2.	`visits[p][n]` reads or writes a single cell, while `pattern(n)` allows word-parallel operations.
+////////////////////////////////
+
+#ifndef SMART_SZX_INVENTORY_ROUTING_VISIT_MATRIX_H
+#define SMART_SZX_INVENTORY_ROUTING_VISIT_MATRIX_H
+
+
+#include "Config.h"
+
+#include <cstdint>
+
+#if _CC_MS_VC
+#include <intrin.h>
+#endif // _CC_MS_VC
+
+#include "Common.h"
+#include "Utility.h"
+
+
+namespace szx {
+
+class VisitMatrix {
+public:
+    using Word = std::uint64_t;
+
+
+    static constexpr ID MaxPeriodNum = 64;
+
+
+    // return the index of the lowest set bit (the earliest period in the set). `w` should not be 0.
+    static ID lowestBit(Word w) {
+        #if _CC_MS_VC
+        unsigned long index;
+        _BitScanForward64(&index, w);
+        return static_cast<ID>(index);
+        #else
+        return static_cast<ID>(__builtin_ctzll(w));
+        #endif // _CC_MS_VC
+    }
+    static Word bit(ID p) { return (static_cast<Word>(1) << p); }
+
+
+    // proxy of a single cell to keep the `visits[p][n]` syntax.
+    class CellRef {
+    public:
+        CellRef(Word &pattern, ID period) : word(pattern), mask(bit(period)) {}
+
+        operator bool() const { return ((word & mask) != 0); }
+
+        CellRef& operator=(bool visited) {
+            if (visited) { word |= mask; } else { word &= ~mask; }
+            return *this;
+        }
+        CellRef& operator=(int visited) { return (*this = (visited != 0)); }
+        CellRef& operator=(const CellRef &cell) { return (*this = static_cast<bool>(cell)); } // assign value instead of reference.
+
+    protected:
+        Word &word;
+        Word mask;
+    };
+
+    class RowRef {
+    public:
+        RowRef(VisitMatrix &visitMatrix, ID period) : visits(visitMatrix), p(period) {}
+        CellRef operator[](ID n) { return CellRef(visits.patterns[n], p); }
+
+    protected:
+        VisitMatrix &visits;
+        ID p;
+    };
+
+    class ConstRowRef {
+    public:
+        ConstRowRef(const VisitMatrix &visitMatrix, ID period) : visits(visitMatrix), p(period) {}
+        bool operator[](ID n) const { return visits.at(p, n); }
+
+    protected:
+        const VisitMatrix &visits;
+        ID p;
+    };
+
+
+    VisitMatrix() : periodNum(0) {}
+    VisitMatrix(ID periodNumber, ID nodeNumber) { init(periodNumber, nodeNumber); }
+
+    void init(ID periodNumber, ID nodeNumber) {
+        if (periodNumber > MaxPeriodNum) { throw "too many periods for the bit-packed visit matrix."; }
+        periodNum = periodNumber;
+        patterns = Arr<Word>(nodeNumber, static_cast<Word>(0)); // assign a new array since Arr::init() does nothing on allocated ones.
+    }
+
+    void reset() { patterns.reset(); }
+    // remove all visits at period p.
+    void clearPeriod(ID p) {
+        Word mask = ~bit(p);
+        for (auto w = patterns.begin(); w != patterns.end(); ++w) { *w &= mask; }
+    }
+    // overwrite the visits at period p by the ones in `visits`.
+    void copyPeriod(const VisitMatrix &visits, ID p) {
+        Word mask = bit(p);
+        for (ID n = 0; n < patterns.size(); ++n) {
+            patterns[n] = (patterns[n] & ~mask) | (visits.patterns[n] & mask);
+        }
+    }
+
+    bool at(ID p, ID n) const { return ((patterns[n] & bit(p)) != 0); }
+    RowRef operator[](ID p) { return RowRef(*this, p); }
+    ConstRowRef operator[](ID p) const { return ConstRowRef(*this, p); }
+
+    // bit p of the pattern is set if node n is visited at period p.
+    Word pattern(ID n) const { return patterns[n]; }
+    void setPattern(ID n, Word w) { patterns[n] = w; }
+    Word allPeriods() const { return (periodNum >= MaxPeriodNum) ? ~static_cast<Word>(0) : (bit(periodNum) - 1); }
+
+    // 64-bit fingerprint of the whole matrix for hashing based caches.
+    Word signature() const {
+        Word h = static_cast<Word>(periodNum);
+        for (ID n = 0; n < patterns.size(); ++n) {
+            h = mix(h ^ (patterns[n] + GoldenRatio * static_cast<Word>(n + 1)));
+        }
+        return h;
+    }
+
+    ID getPeriodNum() const { return periodNum; }
+    ID getNodeNum() const { return patterns.size(); }
+
+protected:
+    static constexpr Word GoldenRatio = 0x9E3779B97F4A7C15ull;
+
+    // finalizer of splitmix64.
+    static Word mix(Word w) {
+        w = (w ^ (w >> 30)) * 0xBF58476D1CE4E5B9ull;
+        w = (w ^ (w >> 27)) * 0x94D049BB133111EBull;
+        return w ^ (w >> 31);
+    }
+
+
+    ID periodNum;
+    Arr<Word> patterns;
+};
+
+}
+
+
+#endif // SMART_SZX_INVENTORY_ROUTING_VISIT_MATRIX_H